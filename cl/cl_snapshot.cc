@@ -0,0 +1,1104 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config_cl.h"
+#include "cl_snapshot.hh"
+
+#include <cl/cl_msg.hh>
+
+#include "cl.hh"
+
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char SNAPSHOT_MAGIC[] = "CLSNAP";
+
+    /// bump this whenever the format changes
+    const unsigned long SNAPSHOT_VERSION = 1;
+
+    enum ESnapshotTag {
+        ST_END = 0,
+        ST_STRING,
+        ST_TYPE,
+        ST_VAR,
+        ST_FILE_OPEN,
+        ST_FILE_CLOSE,
+        ST_FNC_OPEN,
+        ST_FNC_ARG_DECL,
+        ST_FNC_CLOSE,
+        ST_BB_OPEN,
+        ST_INSN,
+        ST_CALL_OPEN,
+        ST_CALL_ARG,
+        ST_CALL_CLOSE,
+        ST_SWITCH_OPEN,
+        ST_SWITCH_CASE,
+        ST_SWITCH_CLOSE
+    };
+
+    typedef std::string TBuf;
+
+    void putUnsigned(TBuf &buf, unsigned long val) {
+        while (0x80 <= val) {
+            buf.push_back(static_cast<char>((val & 0x7F) | 0x80));
+            val >>= 7;
+        }
+
+        buf.push_back(static_cast<char>(val));
+    }
+
+    void putSigned(TBuf &buf, long val) {
+        // zig-zag encoding keeps small negative numbers short
+        const unsigned long uval = static_cast<unsigned long>(val);
+        putUnsigned(buf, (uval << 1) ^ ((val < 0) ? ~0UL : 0UL));
+    }
+
+    void putDouble(TBuf &buf, double val) {
+        char raw[sizeof val];
+        memcpy(raw, &val, sizeof val);
+        buf.append(raw, sizeof raw);
+    }
+
+    /// reference to an object of the given uid, zero stands for NULL
+    unsigned long uidRef(int uid) {
+        const long val = uid;
+        const unsigned long uval = static_cast<unsigned long>(val);
+        return ((uval << 1) ^ ((val < 0) ? ~0UL : 0UL)) + 1;
+    }
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// ClSnapshotWriter
+class ClSnapshotWriter: public ICodeListener {
+    public:
+        ClSnapshotWriter(const char *fileName);
+        virtual ~ClSnapshotWriter();
+
+        virtual void file_open(const char *file_name) {
+            TBuf ev;
+            putUnsigned(ev, ST_FILE_OPEN);
+            this->writeStr(ev, file_name);
+            this->flush(ev);
+        }
+
+        virtual void file_close() {
+            this->writeTag(ST_FILE_CLOSE);
+        }
+
+        virtual void fnc_open(const struct cl_operand *fnc) {
+            TBuf ev;
+            putUnsigned(ev, ST_FNC_OPEN);
+            this->writeOperand(ev, fnc);
+            this->flush(ev);
+        }
+
+        virtual void fnc_arg_decl(int arg_id, const struct cl_operand *arg_src) {
+            TBuf ev;
+            putUnsigned(ev, ST_FNC_ARG_DECL);
+            putSigned(ev, arg_id);
+            this->writeOperand(ev, arg_src);
+            this->flush(ev);
+        }
+
+        virtual void fnc_close() {
+            this->writeTag(ST_FNC_CLOSE);
+        }
+
+        virtual void bb_open(const char *bb_name) {
+            TBuf ev;
+            putUnsigned(ev, ST_BB_OPEN);
+            this->writeStr(ev, bb_name);
+            this->flush(ev);
+        }
+
+        virtual void insn(const struct cl_insn *cli) {
+            TBuf ev;
+            putUnsigned(ev, ST_INSN);
+            this->writeInsn(ev, cli);
+            this->flush(ev);
+        }
+
+        virtual void insn_call_open(
+            const struct cl_loc     *loc,
+            const struct cl_operand *dst,
+            const struct cl_operand *fnc)
+        {
+            TBuf ev;
+            putUnsigned(ev, ST_CALL_OPEN);
+            this->writeLoc(ev, loc);
+            this->writeOperand(ev, dst);
+            this->writeOperand(ev, fnc);
+            this->flush(ev);
+        }
+
+        virtual void insn_call_arg(int arg_id, const struct cl_operand *arg_src)
+        {
+            TBuf ev;
+            putUnsigned(ev, ST_CALL_ARG);
+            putSigned(ev, arg_id);
+            this->writeOperand(ev, arg_src);
+            this->flush(ev);
+        }
+
+        virtual void insn_call_close() {
+            this->writeTag(ST_CALL_CLOSE);
+        }
+
+        virtual void insn_switch_open(
+            const struct cl_loc     *loc,
+            const struct cl_operand *src)
+        {
+            TBuf ev;
+            putUnsigned(ev, ST_SWITCH_OPEN);
+            this->writeLoc(ev, loc);
+            this->writeOperand(ev, src);
+            this->flush(ev);
+        }
+
+        virtual void insn_switch_case(
+            const struct cl_loc     *loc,
+            const struct cl_operand *val_lo,
+            const struct cl_operand *val_hi,
+            const char              *label)
+        {
+            TBuf ev;
+            putUnsigned(ev, ST_SWITCH_CASE);
+            this->writeLoc(ev, loc);
+            this->writeOperand(ev, val_lo);
+            this->writeOperand(ev, val_hi);
+            this->writeStr(ev, label);
+            this->flush(ev);
+        }
+
+        virtual void insn_switch_close() {
+            this->writeTag(ST_SWITCH_CLOSE);
+        }
+
+        virtual void acknowledge();
+
+    private:
+        std::ofstream                           out_;
+        std::string                             fileName_;
+        std::map<std::string, unsigned long>    strings_;
+        std::set<int>                           types_;
+        std::set<int>                           vars_;
+        std::vector<const struct cl_type *>     pendingTypes_;
+        std::vector<const struct cl_var *>      pendingVars_;
+
+    private:
+        void writeTag(ESnapshotTag tag);
+        void writeStr(TBuf &buf, const char *str);
+        void writeType(TBuf &buf, const struct cl_type *clt);
+        void writeVar(TBuf &buf, const struct cl_var *var);
+        void writeLoc(TBuf &buf, const struct cl_loc *loc);
+        void writeCst(TBuf &buf, const struct cl_cst &cst);
+        void writeOperand(TBuf &buf, const struct cl_operand *op);
+        void writeInsn(TBuf &buf, const struct cl_insn *cli);
+        void defineType(const struct cl_type *clt);
+        void defineVar(const struct cl_var *var);
+        void flush(const TBuf &ev);
+};
+
+ClSnapshotWriter::ClSnapshotWriter(const char *fileName):
+    fileName_(fileName)
+{
+    out_.open(fileName, std::ios::out | std::ios::binary);
+    if (out_) {
+        CL_DEBUG("ClSnapshotWriter: created snapshot file '" << fileName << "'");
+    } else {
+        CL_ERROR("unable to create file '" << fileName << "'");
+    }
+
+    TBuf header(SNAPSHOT_MAGIC);
+    putUnsigned(header, SNAPSHOT_VERSION);
+    out_.write(header.data(), header.size());
+}
+
+ClSnapshotWriter::~ClSnapshotWriter()
+{
+    out_.close();
+    if (!out_) {
+        CL_WARN("error detected while closing a file");
+    }
+}
+
+void ClSnapshotWriter::acknowledge()
+{
+    this->writeTag(ST_END);
+    out_.flush();
+    if (!out_)
+        CL_ERROR("unable to write the snapshot to '" << fileName_ << "'");
+}
+
+void ClSnapshotWriter::writeTag(ESnapshotTag tag)
+{
+    TBuf ev;
+    putUnsigned(ev, tag);
+    this->flush(ev);
+}
+
+void ClSnapshotWriter::writeStr(TBuf &buf, const char *str)
+{
+    if (!str) {
+        putUnsigned(buf, 0);
+        return;
+    }
+
+    const unsigned long id = strings_.size();
+    const std::pair<std::map<std::string, unsigned long>::iterator, bool> p =
+        strings_.insert(std::make_pair(std::string(str), id));
+
+    if (p.second) {
+        // strings have no dependencies, so they can be defined right now
+        TBuf def;
+        const size_t len = strlen(str);
+        putUnsigned(def, ST_STRING);
+        putUnsigned(def, len);
+        def.append(str, len + /* NUL */ 1);
+        out_.write(def.data(), def.size());
+    }
+
+    putUnsigned(buf, p.first->second + 1);
+}
+
+void ClSnapshotWriter::writeType(TBuf &buf, const struct cl_type *clt)
+{
+    if (!clt) {
+        putUnsigned(buf, 0);
+        return;
+    }
+
+    if (types_.insert(clt->uid).second)
+        pendingTypes_.push_back(clt);
+
+    putUnsigned(buf, uidRef(clt->uid));
+}
+
+void ClSnapshotWriter::writeVar(TBuf &buf, const struct cl_var *var)
+{
+    if (!var) {
+        putUnsigned(buf, 0);
+        return;
+    }
+
+    if (vars_.insert(var->uid).second)
+        pendingVars_.push_back(var);
+
+    putUnsigned(buf, uidRef(var->uid));
+}
+
+void ClSnapshotWriter::writeLoc(TBuf &buf, const struct cl_loc *loc)
+{
+    if (!loc)
+        loc = &cl_loc_unknown;
+
+    this->writeStr(buf, loc->file);
+    putSigned(buf, loc->line);
+    putSigned(buf, loc->column);
+    putUnsigned(buf, loc->sysp);
+}
+
+void ClSnapshotWriter::writeCst(TBuf &buf, const struct cl_cst &cst)
+{
+    putUnsigned(buf, cst.code);
+    switch (cst.code) {
+        case CL_TYPE_FNC:
+            putSigned(buf, cst.data.cst_fnc.uid);
+            this->writeStr(buf, cst.data.cst_fnc.name);
+            putUnsigned(buf, cst.data.cst_fnc.is_extern);
+            this->writeLoc(buf, &cst.data.cst_fnc.loc);
+            break;
+
+        case CL_TYPE_STRING:
+            this->writeStr(buf, cst.data.cst_string.value);
+            break;
+
+        case CL_TYPE_REAL:
+            putDouble(buf, cst.data.cst_real.value);
+            break;
+
+        default:
+            // cst_uint shares the storage with cst_int
+            putSigned(buf, cst.data.cst_int.value);
+            break;
+    }
+}
+
+void ClSnapshotWriter::writeOperand(TBuf &buf, const struct cl_operand *op)
+{
+    if (!op) {
+        putUnsigned(buf, 0);
+        return;
+    }
+
+    putUnsigned(buf, op->code + 1);
+    putUnsigned(buf, op->scope);
+    this->writeType(buf, op->type);
+
+    unsigned long cntAccessors = 0;
+    for (const struct cl_accessor *ac = op->accessor; ac; ac = ac->next)
+        ++cntAccessors;
+
+    putUnsigned(buf, cntAccessors);
+    for (const struct cl_accessor *ac = op->accessor; ac; ac = ac->next) {
+        putUnsigned(buf, ac->code);
+        this->writeType(buf, ac->type);
+        switch (ac->code) {
+            case CL_ACCESSOR_DEREF_ARRAY:
+                this->writeOperand(buf, ac->data.array.index);
+                break;
+
+            case CL_ACCESSOR_ITEM:
+                putSigned(buf, ac->data.item.id);
+                break;
+
+            case CL_ACCESSOR_OFFSET:
+                putSigned(buf, ac->data.offset.off);
+                break;
+
+            case CL_ACCESSOR_REF:
+            case CL_ACCESSOR_DEREF:
+                break;
+        }
+    }
+
+    switch (op->code) {
+        case CL_OPERAND_VAR:
+            this->writeVar(buf, op->data.var);
+            break;
+
+        case CL_OPERAND_CST:
+            this->writeCst(buf, op->data.cst);
+            break;
+
+        case CL_OPERAND_VOID:
+            break;
+    }
+}
+
+void ClSnapshotWriter::writeInsn(TBuf &buf, const struct cl_insn *cli)
+{
+    putUnsigned(buf, cli->code);
+    this->writeLoc(buf, &cli->loc);
+    switch (cli->code) {
+        case CL_INSN_JMP:
+            this->writeStr(buf, cli->data.insn_jmp.label);
+            break;
+
+        case CL_INSN_COND:
+            this->writeOperand(buf, cli->data.insn_cond.src);
+            this->writeStr(buf, cli->data.insn_cond.then_label);
+            this->writeStr(buf, cli->data.insn_cond.else_label);
+            break;
+
+        case CL_INSN_RET:
+            this->writeOperand(buf, cli->data.insn_ret.src);
+            break;
+
+        case CL_INSN_UNOP:
+            putUnsigned(buf, cli->data.insn_unop.code);
+            this->writeOperand(buf, cli->data.insn_unop.dst);
+            this->writeOperand(buf, cli->data.insn_unop.src);
+            break;
+
+        case CL_INSN_BINOP:
+            putUnsigned(buf, cli->data.insn_binop.code);
+            this->writeOperand(buf, cli->data.insn_binop.dst);
+            this->writeOperand(buf, cli->data.insn_binop.src1);
+            this->writeOperand(buf, cli->data.insn_binop.src2);
+            break;
+
+        case CL_INSN_LABEL:
+            this->writeStr(buf, cli->data.insn_label.name);
+            break;
+
+        case CL_INSN_NOP:
+        case CL_INSN_ABORT:
+            break;
+
+        case CL_INSN_CALL:
+        case CL_INSN_SWITCH:
+            // these come through insn_call_*() and insn_switch_*()
+            CL_BREAK_IF("ClSnapshotWriter::writeInsn() got an invalid insn");
+            break;
+    }
+}
+
+void ClSnapshotWriter::defineType(const struct cl_type *clt)
+{
+    TBuf def;
+    putUnsigned(def, ST_TYPE);
+    putSigned(def, clt->uid);
+    putUnsigned(def, clt->code);
+    this->writeLoc(def, &clt->loc);
+    putUnsigned(def, clt->scope);
+    this->writeStr(def, clt->name);
+    putSigned(def, clt->size);
+    putUnsigned(def, clt->item_cnt);
+    for (int i = 0; i < clt->item_cnt; ++i) {
+        const struct cl_type_item &item = clt->items[i];
+        this->writeType(def, item.type);
+        this->writeStr(def, item.name);
+        putSigned(def, item.offset);
+    }
+    putSigned(def, clt->array_size);
+    putUnsigned(def, clt->is_unsigned);
+
+    out_.write(def.data(), def.size());
+}
+
+void ClSnapshotWriter::defineVar(const struct cl_var *var)
+{
+    TBuf def;
+    putUnsigned(def, ST_VAR);
+    putSigned(def, var->uid);
+    this->writeStr(def, var->name);
+    putUnsigned(def, var->artificial);
+    this->writeLoc(def, &var->loc);
+    putUnsigned(def, var->initialized);
+    putUnsigned(def, var->is_extern);
+
+    unsigned long cntInitials = 0;
+    for (const struct cl_initializer *in = var->initial; in; in = in->next)
+        ++cntInitials;
+
+    putUnsigned(def, cntInitials);
+    for (const struct cl_initializer *in = var->initial; in; in = in->next)
+        this->writeInsn(def, &in->insn);
+
+    out_.write(def.data(), def.size());
+}
+
+void ClSnapshotWriter::flush(const TBuf &ev)
+{
+    // the types and variables referred to by the event go first, they may
+    // refer to each other in any order as the reader resolves them by uid
+    while (!pendingTypes_.empty() || !pendingVars_.empty()) {
+        if (!pendingTypes_.empty()) {
+            const struct cl_type *clt = pendingTypes_.back();
+            pendingTypes_.pop_back();
+            this->defineType(clt);
+        }
+        else {
+            const struct cl_var *var = pendingVars_.back();
+            pendingVars_.pop_back();
+            this->defineVar(var);
+        }
+    }
+
+    out_.write(ev.data(), ev.size());
+}
+
+ICodeListener* createClSnapshotWriter(const char *config_string)
+{
+    return new ClSnapshotWriter(config_string);
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// cl_snapshot
+struct cl_snapshot {
+    private:
+        const unsigned char                     *beg_;
+        const unsigned char                     *cur_;
+        const unsigned char                     *end_;
+        bool                                    ok_;
+
+        std::vector<const char *>               strings_;
+        std::map<int, struct cl_type *>         types_;
+        std::map<int, struct cl_var *>          vars_;
+
+        /// types and variables referred to but not defined yet
+        std::set<const void *>                  undefined_;
+
+        // the loaded objects live as long as the snapshot
+        std::deque<struct cl_type>              typeArena_;
+        std::deque<struct cl_var>               varArena_;
+        std::deque<struct cl_operand>           opArena_;
+        std::deque<struct cl_accessor>          acArena_;
+        std::deque<struct cl_initializer>       initArena_;
+        std::deque<std::vector<cl_type_item> >  itemArena_;
+
+    public:
+        cl_snapshot(const unsigned char *beg, const unsigned char *end):
+            beg_(beg),
+            cur_(beg),
+            end_(end),
+            ok_(true)
+        {
+        }
+
+        ~cl_snapshot() {
+            munmap(const_cast<unsigned char *>(beg_), end_ - beg_);
+        }
+
+        bool replay(struct cl_code_listener *cl);
+
+    private:
+        unsigned long getUnsigned();
+        long getSigned();
+        double getDouble();
+        int getEnum(int max);
+        const char* getStr();
+        struct cl_type* getType();
+        struct cl_var* getVar();
+        void getLoc(struct cl_loc &loc);
+        void getCst(struct cl_cst &cst);
+        const struct cl_operand* getOperand();
+        void getInsn(struct cl_insn &cli);
+        void readString();
+        void readType();
+        void readVar();
+};
+
+unsigned long cl_snapshot::getUnsigned()
+{
+    unsigned long val = 0;
+    for (unsigned shift = 0; ok_; shift += 7) {
+        if (cur_ == end_ || (8 * sizeof val) <= shift) {
+            ok_ = false;
+            break;
+        }
+
+        const unsigned char byte = *cur_++;
+        val |= static_cast<unsigned long>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return val;
+    }
+
+    return 0;
+}
+
+long cl_snapshot::getSigned()
+{
+    const unsigned long val = this->getUnsigned();
+    return static_cast<long>(val >> 1) ^ -static_cast<long>(val & 1);
+}
+
+double cl_snapshot::getDouble()
+{
+    double val = 0.0;
+    if (static_cast<size_t>(end_ - cur_) < sizeof val) {
+        ok_ = false;
+        return val;
+    }
+
+    memcpy(&val, cur_, sizeof val);
+    cur_ += sizeof val;
+    return val;
+}
+
+int cl_snapshot::getEnum(int max)
+{
+    const unsigned long val = this->getUnsigned();
+    if (static_cast<unsigned long>(max) < val) {
+        ok_ = false;
+        return 0;
+    }
+
+    return static_cast<int>(val);
+}
+
+const char* cl_snapshot::getStr()
+{
+    const unsigned long ref = this->getUnsigned();
+    if (!ref)
+        return 0;
+
+    if (strings_.size() < ref) {
+        ok_ = false;
+        return 0;
+    }
+
+    return strings_[ref - 1];
+}
+
+struct cl_type* cl_snapshot::getType()
+{
+    const unsigned long ref = this->getUnsigned();
+    if (!ref)
+        return 0;
+
+    const unsigned long val = ref - 1;
+    const int uid = static_cast<int>(static_cast<long>(val >> 1)
+            ^ -static_cast<long>(val & 1));
+
+    struct cl_type *&clt = types_[uid];
+    if (!clt) {
+        // not defined yet, the definition may follow
+        typeArena_.push_back(cl_type());
+        clt = &typeArena_.back();
+        clt->uid = uid;
+        undefined_.insert(clt);
+    }
+
+    return clt;
+}
+
+struct cl_var* cl_snapshot::getVar()
+{
+    const unsigned long ref = this->getUnsigned();
+    if (!ref)
+        return 0;
+
+    const unsigned long val = ref - 1;
+    const int uid = static_cast<int>(static_cast<long>(val >> 1)
+            ^ -static_cast<long>(val & 1));
+
+    struct cl_var *&var = vars_[uid];
+    if (!var) {
+        // not defined yet, the definition may follow
+        varArena_.push_back(cl_var());
+        var = &varArena_.back();
+        var->uid = uid;
+        undefined_.insert(var);
+    }
+
+    return var;
+}
+
+void cl_snapshot::getLoc(struct cl_loc &loc)
+{
+    loc.file    = this->getStr();
+    loc.line    = this->getSigned();
+    loc.column  = this->getSigned();
+    loc.sysp    = this->getUnsigned();
+}
+
+void cl_snapshot::getCst(struct cl_cst &cst)
+{
+    cst.code = static_cast<enum cl_type_e>(this->getEnum(CL_TYPE_STRING));
+    switch (cst.code) {
+        case CL_TYPE_FNC:
+            cst.data.cst_fnc.uid        = this->getSigned();
+            cst.data.cst_fnc.name       = this->getStr();
+            cst.data.cst_fnc.is_extern  = this->getUnsigned();
+            this->getLoc(cst.data.cst_fnc.loc);
+            break;
+
+        case CL_TYPE_STRING:
+            cst.data.cst_string.value   = this->getStr();
+            break;
+
+        case CL_TYPE_REAL:
+            cst.data.cst_real.value     = this->getDouble();
+            break;
+
+        default:
+            cst.data.cst_int.value      = this->getSigned();
+            break;
+    }
+}
+
+const struct cl_operand* cl_snapshot::getOperand()
+{
+    const int code = this->getEnum(CL_OPERAND_VAR + 1);
+    if (!code)
+        return 0;
+
+    opArena_.push_back(cl_operand());
+    struct cl_operand *op = &opArena_.back();
+    op->code    = static_cast<enum cl_operand_e>(code - 1);
+    op->scope   = static_cast<enum cl_scope_e>(this->getEnum(CL_SCOPE_FUNCTION));
+    op->type    = this->getType();
+
+    struct cl_accessor **pac = &op->accessor;
+    for (unsigned long cnt = this->getUnsigned(); ok_ && cnt; --cnt) {
+        acArena_.push_back(cl_accessor());
+        struct cl_accessor *ac = &acArena_.back();
+        ac->code = static_cast<enum cl_accessor_e>(
+                this->getEnum(CL_ACCESSOR_OFFSET));
+        ac->type = this->getType();
+
+        switch (ac->code) {
+            case CL_ACCESSOR_DEREF_ARRAY:
+                ac->data.array.index = const_cast<struct cl_operand *>(
+                        this->getOperand());
+                break;
+
+            case CL_ACCESSOR_ITEM:
+                ac->data.item.id = this->getSigned();
+                break;
+
+            case CL_ACCESSOR_OFFSET:
+                ac->data.offset.off = this->getSigned();
+                break;
+
+            case CL_ACCESSOR_REF:
+            case CL_ACCESSOR_DEREF:
+                break;
+        }
+
+        *pac = ac;
+        pac = &ac->next;
+    }
+
+    switch (op->code) {
+        case CL_OPERAND_VAR:
+            op->data.var = this->getVar();
+            break;
+
+        case CL_OPERAND_CST:
+            this->getCst(op->data.cst);
+            break;
+
+        case CL_OPERAND_VOID:
+            break;
+    }
+
+    return op;
+}
+
+void cl_snapshot::getInsn(struct cl_insn &cli)
+{
+    cli.code = static_cast<enum cl_insn_e>(this->getEnum(CL_INSN_LABEL));
+    this->getLoc(cli.loc);
+    switch (cli.code) {
+        case CL_INSN_JMP:
+            cli.data.insn_jmp.label = this->getStr();
+            break;
+
+        case CL_INSN_COND:
+            cli.data.insn_cond.src          = this->getOperand();
+            cli.data.insn_cond.then_label   = this->getStr();
+            cli.data.insn_cond.else_label   = this->getStr();
+            break;
+
+        case CL_INSN_RET:
+            cli.data.insn_ret.src = this->getOperand();
+            break;
+
+        case CL_INSN_UNOP:
+            cli.data.insn_unop.code = static_cast<enum cl_unop_e>(
+                    this->getEnum(CL_UNOP_FLOAT));
+            cli.data.insn_unop.dst  = this->getOperand();
+            cli.data.insn_unop.src  = this->getOperand();
+            break;
+
+        case CL_INSN_BINOP:
+            cli.data.insn_binop.code = static_cast<enum cl_binop_e>(
+                    this->getEnum(CL_BINOP_RROTATE));
+            cli.data.insn_binop.dst  = this->getOperand();
+            cli.data.insn_binop.src1 = this->getOperand();
+            cli.data.insn_binop.src2 = this->getOperand();
+            break;
+
+        case CL_INSN_LABEL:
+            cli.data.insn_label.name = this->getStr();
+            break;
+
+        case CL_INSN_NOP:
+        case CL_INSN_ABORT:
+            break;
+
+        case CL_INSN_CALL:
+        case CL_INSN_SWITCH:
+            ok_ = false;
+            break;
+    }
+}
+
+void cl_snapshot::readString()
+{
+    const unsigned long len = this->getUnsigned();
+    if (!ok_ || static_cast<unsigned long>(end_ - cur_) <= len || cur_[len]) {
+        ok_ = false;
+        return;
+    }
+
+    // the strings are used in place, they stay mapped as long as the snapshot
+    strings_.push_back(reinterpret_cast<const char *>(cur_));
+    cur_ += len + /* NUL */ 1;
+}
+
+void cl_snapshot::readType()
+{
+    const int uid = this->getSigned();
+    struct cl_type *&clt = types_[uid];
+    if (!clt) {
+        typeArena_.push_back(cl_type());
+        clt = &typeArena_.back();
+    }
+    else if (!undefined_.erase(clt)) {
+        // defined twice
+        ok_ = false;
+        return;
+    }
+
+    clt->uid    = uid;
+    clt->code   = static_cast<enum cl_type_e>(this->getEnum(CL_TYPE_STRING));
+    this->getLoc(clt->loc);
+    clt->scope  = static_cast<enum cl_scope_e>(
+            this->getEnum(CL_SCOPE_FUNCTION));
+    clt->name   = this->getStr();
+    clt->size   = this->getSigned();
+
+    const unsigned long cntItems = this->getUnsigned();
+    if (static_cast<unsigned long>(end_ - cur_) < cntItems) {
+        // each item takes at least one byte
+        ok_ = false;
+        return;
+    }
+
+    clt->item_cnt = cntItems;
+    clt->items = 0;
+    if (cntItems) {
+        itemArena_.push_back(std::vector<cl_type_item>(cntItems));
+        clt->items = &itemArena_.back()[0];
+    }
+
+    for (unsigned long i = 0; ok_ && i < cntItems; ++i) {
+        struct cl_type_item &item = clt->items[i];
+        item.type   = this->getType();
+        item.name   = this->getStr();
+        item.offset = this->getSigned();
+    }
+
+    clt->array_size     = this->getSigned();
+    clt->is_unsigned    = this->getUnsigned();
+}
+
+void cl_snapshot::readVar()
+{
+    const int uid = this->getSigned();
+    struct cl_var *&var = vars_[uid];
+    if (!var) {
+        varArena_.push_back(cl_var());
+        var = &varArena_.back();
+    }
+    else if (!undefined_.erase(var)) {
+        // defined twice
+        ok_ = false;
+        return;
+    }
+
+    var->uid            = uid;
+    var->name           = this->getStr();
+    var->artificial     = this->getUnsigned();
+    this->getLoc(var->loc);
+    var->initialized    = this->getUnsigned();
+    var->is_extern      = this->getUnsigned();
+
+    struct cl_initializer **pin = &var->initial;
+    for (unsigned long cnt = this->getUnsigned(); ok_ && cnt; --cnt) {
+        initArena_.push_back(cl_initializer());
+        struct cl_initializer *in = &initArena_.back();
+        this->getInsn(in->insn);
+
+        *pin = in;
+        pin = &in->next;
+    }
+}
+
+bool cl_snapshot::replay(struct cl_code_listener *cl)
+{
+    const size_t lenMagic = sizeof SNAPSHOT_MAGIC - 1;
+    if (static_cast<size_t>(end_ - cur_) < lenMagic
+            || memcmp(cur_, SNAPSHOT_MAGIC, lenMagic)) {
+        CL_ERROR("not a code listener snapshot");
+        return false;
+    }
+
+    cur_ += lenMagic;
+    const unsigned long version = this->getUnsigned();
+    if (SNAPSHOT_VERSION != version) {
+        CL_ERROR("unsupported version of code listener snapshot: " << version);
+        return false;
+    }
+
+    while (ok_) {
+        const int tag = this->getEnum(ST_SWITCH_CLOSE);
+
+        // definitions
+        switch (tag) {
+            case ST_STRING:
+                this->readString();
+                continue;
+
+            case ST_TYPE:
+                this->readType();
+                continue;
+
+            case ST_VAR:
+                this->readVar();
+                continue;
+
+            default:
+                break;
+        }
+
+        // decode the event
+        const char *str = 0;
+        int argId = 0;
+        struct cl_loc loc;
+        struct cl_insn cli;
+        const struct cl_operand *op1 = 0, *op2 = 0;
+        switch (tag) {
+            case ST_FILE_OPEN:
+            case ST_BB_OPEN:
+                str = this->getStr();
+                break;
+
+            case ST_FNC_OPEN:
+                op1 = this->getOperand();
+                break;
+
+            case ST_FNC_ARG_DECL:
+            case ST_CALL_ARG:
+                argId = this->getSigned();
+                op1 = this->getOperand();
+                break;
+
+            case ST_INSN:
+                this->getInsn(cli);
+                break;
+
+            case ST_CALL_OPEN:
+                this->getLoc(loc);
+                op1 = this->getOperand();
+                op2 = this->getOperand();
+                break;
+
+            case ST_SWITCH_OPEN:
+                this->getLoc(loc);
+                op1 = this->getOperand();
+                break;
+
+            case ST_SWITCH_CASE:
+                this->getLoc(loc);
+                op1 = this->getOperand();
+                op2 = this->getOperand();
+                str = this->getStr();
+                break;
+
+            default:
+                break;
+        }
+
+        if (!ok_ || !undefined_.empty())
+            break;
+
+        // dispatch the event
+        switch (tag) {
+            case ST_END:
+                return true;
+
+            case ST_FILE_OPEN:
+                cl->file_open(cl, str);
+                break;
+
+            case ST_FILE_CLOSE:
+                cl->file_close(cl);
+                break;
+
+            case ST_FNC_OPEN:
+                cl->fnc_open(cl, op1);
+                break;
+
+            case ST_FNC_ARG_DECL:
+                cl->fnc_arg_decl(cl, argId, op1);
+                break;
+
+            case ST_FNC_CLOSE:
+                cl->fnc_close(cl);
+                break;
+
+            case ST_BB_OPEN:
+                cl->bb_open(cl, str);
+                break;
+
+            case ST_INSN:
+                cl->insn(cl, &cli);
+                break;
+
+            case ST_CALL_OPEN:
+                cl->insn_call_open(cl, &loc, op1, op2);
+                break;
+
+            case ST_CALL_ARG:
+                cl->insn_call_arg(cl, argId, op1);
+                break;
+
+            case ST_CALL_CLOSE:
+                cl->insn_call_close(cl);
+                break;
+
+            case ST_SWITCH_OPEN:
+                cl->insn_switch_open(cl, &loc, op1);
+                break;
+
+            case ST_SWITCH_CASE:
+                cl->insn_switch_case(cl, &loc, op1, op2, str);
+                break;
+
+            case ST_SWITCH_CLOSE:
+                cl->insn_switch_close(cl);
+                break;
+        }
+    }
+
+    CL_ERROR("code listener snapshot is corrupted at offset " << (cur_ - beg_));
+    return false;
+}
+
+struct cl_snapshot* cl_snapshot_open(const char *file_name)
+{
+    const int fd = open(file_name, O_RDONLY);
+    if (fd < 0) {
+        CL_ERROR("unable to open file '" << file_name << "'");
+        return 0;
+    }
+
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (!fstat(fd, &st) && 0 < st.st_size)
+        data = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+    if (MAP_FAILED == data) {
+        CL_ERROR("unable to map file '" << file_name << "'");
+        return 0;
+    }
+
+    const unsigned char *beg = static_cast<const unsigned char *>(data);
+    return new cl_snapshot(beg, beg + st.st_size);
+}
+
+bool cl_snapshot_replay(
+        struct cl_snapshot              *snapshot,
+        struct cl_code_listener         *listener)
+{
+    return snapshot->replay(listener);
+}
+
+void cl_snapshot_close(struct cl_snapshot *snapshot)
+{
+    delete snapshot;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_CL_SNAPSHOT_H
+#define H_GUARD_CL_SNAPSHOT_H
+
+/**
+ * @file cl_snapshot.hh
+ * constructor createClSnapshotWriter() of the @b "snapshot" code listener
+ *
+ * A snapshot is a compact binary recording of the code listener events.  It
+ * starts with the magic "CLSNAP" followed by the format version.  Types,
+ * variables and strings are stored only once and referred to afterwards.  All
+ * the numbers are stored as LEB128 varints.  A snapshot can be replayed into
+ * any code listener by cl_snapshot_open(), cl_snapshot_replay(), and
+ * cl_snapshot_close() without running the compiler again.
+ */
+
+class ICodeListener;
+
+/**
+ * create "snapshot" ICodeListener implementation
+ * @param config_string Name of the output file is the only configuration
+ * string for now. It's an compulsory argument and can't be NULL.
+ */
+ICodeListener* createClSnapshotWriter(const char *config_string);
+
+#endif /* H_GUARD_CL_SNAPSHOT_H */
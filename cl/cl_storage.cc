@@ -355,7 +355,12 @@ ClStorageBuilder::~ClStorageBuilder()
 
 void ClStorageBuilder::acknowledge()
 {
-    this->run(d->stor);
+    Storage &stor = d->stor;
+    stor.types.finalize();
+    stor.vars.finalize();
+    stor.fncs.finalize();
+
+    this->run(stor);
 }
 
 void ClStorageBuilder::Private::digInitials(const TOp *op)
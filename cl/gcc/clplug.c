@@ -159,8 +159,10 @@ static struct plugin_info cl_info = {
 "    -fplugin-arg-%s-args=PEER_ARGS                 args given to analyzer\n"
 "    -fplugin-arg-%s-dry-run                        do not run the analyzer\n"
 "    -fplugin-arg-%s-dump-pp[=OUTPUT_FILE]          dump linearized code\n"
+"    -fplugin-arg-%s-dump-snapshot=SNAPSHOT_FILE    record code for later runs\n"
 "    -fplugin-arg-%s-dump-types                     dump also type info\n"
 "    -fplugin-arg-%s-gen-dot[=GLOBAL_CG_FILE]       generate CFGs\n"
+"    -fplugin-arg-%s-load-snapshot=SNAPSHOT_FILE    analyze recorded code\n"
 "    -fplugin-arg-%s-pid-file=FILE                  write PID of self to FILE\n"
 "    -fplugin-arg-%s-preserve-ec                    do not affect exit code\n"
 "    -fplugin-arg-%s-type-dot=TYPE_GRAPH_FILE       generate type graphs\n"
@@ -211,7 +213,8 @@ static void init_plugin_name(const struct plugin_name_args *info)
     if (-1 == asprintf(&msg, cl_info.help, plugin_base_name,
                        name, name, name, name,
                        name, name, name, name,
-                       name, name, name, name))
+                       name, name, name, name,
+                       name, name))
         // OOM
         abort();
     else
@@ -1966,6 +1969,8 @@ struct cl_plug_options {
     const char              *analyzer_args;
     const char              *type_dot_file;
     const char              *pid_file;
+    const char              *snapshot_out_file;
+    const char              *snapshot_in_file;
 };
 
 static int clplug_init(const struct plugin_name_args *info,
@@ -2015,6 +2020,22 @@ static int clplug_init(const struct plugin_name_args *info,
             opt->use_pp         = true;
             opt->pp_out_file    = value;
         }
+        else if (STREQ(key, "dump-snapshot")) {
+            if (value)
+                opt->snapshot_out_file = value;
+            else {
+                CL_ERROR("mandatory value omitted for dump-snapshot");
+                return EXIT_FAILURE;
+            }
+        }
+        else if (STREQ(key, "load-snapshot")) {
+            if (value)
+                opt->snapshot_in_file = value;
+            else {
+                CL_ERROR("mandatory value omitted for load-snapshot");
+                return EXIT_FAILURE;
+            }
+        }
         else if (STREQ(key, "dump-types")) {
             opt->dump_types     = true;
             // TODO: warn about ignoring extra value?
@@ -2106,6 +2127,12 @@ create_cl_chain(const struct cl_plug_options *opt)
         return NULL;
 #endif
 
+    // record the events as they come, the filters are applied on replay
+    if (opt->snapshot_out_file && !cl_append_listener(chain,
+                "listener=\"snapshot\" listener_args=\"%s\"",
+                opt->snapshot_out_file))
+        return NULL;
+
     if (opt->use_pp) {
         const char *use_listener = (opt->dump_types)
             ? "pp_with_types"
@@ -2162,6 +2189,29 @@ static bool write_pid_file(const char *pid_file)
     return true;
 }
 
+// feed the chain from a snapshot instead of the gcc front-end
+static int run_snapshot(const char *snapshot_file)
+{
+    struct cl_snapshot *snapshot = cl_snapshot_open(snapshot_file);
+    const bool replayed = snapshot && cl_snapshot_replay(snapshot, cl);
+    if (replayed)
+        // this should trigger the code listener analyzer (if any)
+        cl->acknowledge(cl);
+
+    // final cleanup
+    cl->destroy(cl);
+    if (snapshot)
+        cl_snapshot_close(snapshot);
+
+    cl_global_cleanup();
+
+    // a corrupted snapshot is a failure even if preserve-ec is given
+    if (!replayed || (cnt_errors && !preserve_ec))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
 // plug-in initialization according to gcc plug-in API
 __attribute__ ((__visibility__ ("default")))
 int plugin_init(struct plugin_name_args *plugin_info,
@@ -2213,6 +2263,10 @@ int plugin_init(struct plugin_name_args *plugin_info,
     cl = create_cl_chain(&opt);
     CL_ASSERT(cl);
 
+    if (opt.snapshot_in_file)
+        // the code has already been recorded, gcc has nothing to do
+        exit(run_snapshot(opt.snapshot_in_file));
+
     // initialize type database and var database
     type_db = type_db_create();
     var_db = var_db_create();
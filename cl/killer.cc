@@ -30,9 +30,12 @@
 #include "stopwatch.hh"
 #include "util.hh"
 
+#include <iomanip>
 #include <map>
 #include <set>
+#include <stack>
 
+#include <boost/dynamic_bitset.hpp>
 #include <boost/foreach.hpp>
 
 static int debugVarKiller = CL_DEBUG_VAR_KILLER;
@@ -60,7 +63,11 @@ typedef const CodeStorage::Fnc             *TFnc;
 typedef std::set<TVar>                      TSet;
 typedef const Block                        *TBlock;
 typedef std::set<TBlock>                    TBlockSet;
-typedef std::vector<TSet>                   TLivePerTarget;
+typedef std::vector<TBlock>                 TBlockList;
+
+/// variables indexed by their dense numbering within a function
+typedef boost::dynamic_bitset<>             TBits;
+typedef std::vector<TBits>                  TLivePerTarget;
 
 /// per-block data
 struct BlockData {
@@ -68,6 +75,14 @@ struct BlockData {
     TSet                                    kill;
 };
 
+/// per-block data of the fixed-point computation
+struct BlockBits {
+    TBits                                   gen;    ///< live-in at the end
+    TBits                                   kill;
+    std::vector<unsigned>                   succs;
+    std::vector<unsigned>                   preds;
+};
+
 typedef std::map<TBlock, BlockData>         TMap;
 
 typedef std::map<int, int>                  TAliasMap;
@@ -75,11 +90,19 @@ typedef std::map<int, int>                  TAliasMap;
 /// shared data
 struct Data {
     TStorRef                                stor;
-    TBlockSet                               todo;
     TMap                                    blocks;
     TFnc                                    fnc;
     TAliasMap                               derefAliases;
 
+    /// basic blocks in post-order, which suits the backward analysis
+    TBlockList                              blockList;
+    std::map<TBlock, unsigned>              blockIdx;
+    std::vector<BlockBits>                  bits;
+
+    /// dense numbering of variables that are ever generated or killed
+    std::map<TVar, unsigned>                varIdx;
+    std::vector<TVar>                       varByIdx;
+
     Data(TStorRef stor_):
         stor(stor_),
         fnc(0)
@@ -273,49 +296,129 @@ void scanInsn(Data &data, BlockData &bData, const Insn &insn)
     }
 }
 
-void updateBlock(Data &data, TBlock bb)
+/// number the basic blocks in post-order, the entry block is visited first
+void numberBlocks(Data &data, const ControlFlow &cfg)
 {
-    VK_DEBUG_MSG(2, &bb->front()->loc, "updateBlock: " << bb->name());
-    BlockData &bData = data.blocks[bb];
-    bool anyChange = false;
+    typedef std::pair<TBlock, unsigned /* next target */> TItem;
+    TBlockSet seen;
+
+    BOOST_FOREACH(const TBlock root, cfg) {
+        if (!insertOnce(seen, root))
+            continue;
 
-    // go through all variables generated by successors
-    BOOST_FOREACH(TBlock bbSrc, bb->targets()) {
-        BlockData &bDataSrc = data.blocks[bbSrc];
+        // non-recursive DFS
+        std::stack<TItem> dfs;
+        dfs.push(TItem(root, 0U));
+        while (!dfs.empty()) {
+            TItem &item = dfs.top();
+            const TBlock bb = item.first;
+            const TTargetList &targets = bb->targets();
+            if (item.second < targets.size()) {
+                const TBlock next = targets[item.second++];
+                if (insertOnce(seen, next))
+                    dfs.push(TItem(next, 0U));
 
-        // update self
-        BOOST_FOREACH(TVar uid, bDataSrc.gen) {
-            if (hasKey(bData.kill, uid))
-                // we are killing the variable
                 continue;
+            }
 
-            if (insertOnce(bData.gen, uid))
-                anyChange = true;
+            data.blockIdx[bb] = data.blockList.size();
+            data.blockList.push_back(bb);
+            dfs.pop();
         }
     }
+}
 
-    if (!anyChange)
-        // nothing updated actually
-        return;
+/// number all the variables generated or killed in any of the blocks
+void numberVars(Data &data)
+{
+    // std::set keeps the numbering in the same order as uids
+    TSet all;
+    BOOST_FOREACH(TMap::const_reference item, data.blocks) {
+        const BlockData &bData = item.second;
+        all.insert(bData.gen.begin(), bData.gen.end());
+        all.insert(bData.kill.begin(), bData.kill.end());
+    }
 
-    // schedule all predecessors
-    BOOST_FOREACH(TBlock bbDst, bb->inbound())
-        data.todo.insert(bbDst);
+    BOOST_FOREACH(TAliasMap::const_reference item, data.derefAliases)
+        all.insert(item.second);
+
+    BOOST_FOREACH(TVar uid, all) {
+        data.varIdx[uid] = data.varByIdx.size();
+        data.varByIdx.push_back(uid);
+    }
+}
+
+inline unsigned varIdxOf(Data &data, TVar uid)
+{
+    CL_BREAK_IF(!hasKey(data.varIdx, uid));
+    return data.varIdx[uid];
+}
+
+TBits toBits(Data &data, const TSet &vars)
+{
+    TBits bits(data.varByIdx.size());
+    BOOST_FOREACH(TVar uid, vars)
+        bits.set(varIdxOf(data, uid));
+
+    return bits;
+}
+
+/// turn the per-block sets into bit-vectors, link the blocks by their indexes
+void buildBits(Data &data)
+{
+    const unsigned cntBlocks = data.blockList.size();
+    data.bits.resize(cntBlocks);
+
+    for (unsigned idx = 0; idx < cntBlocks; ++idx) {
+        const TBlock bb = data.blockList[idx];
+        const BlockData &bData = data.blocks[bb];
+        BlockBits &bits = data.bits[idx];
+        bits.gen  = toBits(data, bData.gen);
+        bits.kill = toBits(data, bData.kill);
+
+        BOOST_FOREACH(TBlock bbSrc, bb->targets())
+            bits.succs.push_back(data.blockIdx[bbSrc]);
+
+        BOOST_FOREACH(TBlock bbDst, bb->inbound())
+            bits.preds.push_back(data.blockIdx[bbDst]);
+    }
+
+    // the sets are not needed any more
+    data.blocks.clear();
 }
 
 void computeFixPoint(Data &data)
 {
+    // schedule all blocks, successors are computed before their predecessors
+    std::set<unsigned> todo;
+    const unsigned cntBlocks = data.bits.size();
+    for (unsigned idx = 0; idx < cntBlocks; ++idx)
+        todo.insert(todo.end(), idx);
+
     // fixed-point computation
     unsigned cntSteps = 1;
-    TBlockSet &todo = data.todo;
+    TBits out(data.varByIdx.size());
     while (!todo.empty()) {
-        TBlockSet::iterator i = todo.begin();
-        TBlock bb = *i;
+        const std::set<unsigned>::iterator i = todo.begin();
+        BlockBits &bits = data.bits[*i];
         todo.erase(i);
-
-        // (re)compute a single basic block
-        updateBlock(data, bb);
         ++cntSteps;
+
+        // go through all variables generated by successors
+        out.reset();
+        BOOST_FOREACH(unsigned succ, bits.succs)
+            out |= data.bits[succ].gen;
+
+        // unless we are killing the variable
+        out -= bits.kill;
+        if (out.is_subset_of(bits.gen))
+            // nothing updated actually
+            continue;
+
+        // update self and schedule all predecessors
+        bits.gen |= out;
+        BOOST_FOREACH(unsigned pred, bits.preds)
+            todo.insert(pred);
     }
 
     VK_DEBUG(2, "fixed-point reached in " << cntSteps << " steps");
@@ -355,7 +458,7 @@ void killVariablePerTarget(
 void commitInsn(
         Data                    &data,
         Insn                    &insn,
-        TSet                    &live,
+        TBits                   &live,
         TLivePerTarget          &livePerTarget)
 {
     const TStorRef stor = data.stor;
@@ -379,8 +482,11 @@ void commitInsn(
     // go through variables generated by the current instruction
     BOOST_FOREACH(TVar vKill, touched) {
         const bool isPointed = isPointedUid(data, vKill);
+        const unsigned idx = varIdxOf(data, vKill);
+
+        if (!live.test(idx)) {
+            live.set(idx);
 
-        if (insertOnce(live, vKill)) {
             // variable was marked as dead in following instruction -- may be
             // killed after execution of this instruction
             VK_DEBUG_MSG(1, &insn.loc, "killing variable "
@@ -396,14 +502,14 @@ void commitInsn(
                 // to prevent following code to re-kill it again for particular
                 // target
                 for (unsigned i = 0; i < cntTargets; ++i)
-                    livePerTarget[i].insert(vKill);
+                    livePerTarget[i].set(idx);
             }
         }
 
         if (!hasKey(arena.gen, vKill)) {
             // this variable is killed by this instruction && is _not_ generated
             // by following instructions.  Therefore it must be marked as dead.
-            live.erase(vKill);
+            live.reset(idx);
             // NOTE: It is not possible to re-kill the 'vKill' for particular
             // targets *only* because:
             //   a) future turns: 'vKill' is is not generated => is dead for
@@ -421,18 +527,20 @@ void commitInsn(
         // means that it is "live" at least in one of the block targets) try to
         // kill it for those particular targets
         for (unsigned i = 0; i < cntTargets; ++i) {
-            if (!insertOnce(livePerTarget[i], vKill))
+            if (livePerTarget[i].test(idx))
                 continue;
 
+            livePerTarget[i].set(idx);
             killVariablePerTarget(data, bb, i, vKill);
         }
     }
 }
 
-void commitBlock(Data &data, TBlock bb)
+void commitBlock(Data &data, unsigned bbIdx)
 {
-    const TTargetList &targets = bb->targets();
-    const unsigned cntTargets = targets.size();
+    const TBlock bb = data.blockList[bbIdx];
+    const BlockBits &bits = data.bits[bbIdx];
+    const unsigned cntTargets = bits.succs.size();
     const bool multipleTargets = (1 < cntTargets);
 
     TLivePerTarget livePerTarget;
@@ -440,20 +548,18 @@ void commitBlock(Data &data, TBlock bb)
         livePerTarget.resize(cntTargets);
 
     // build list of live variables coming from all successors
-    TSet live;
+    TBits live(data.varByIdx.size());
     for (unsigned i = 0; i < cntTargets; ++i) {
-        const TBlock bbSrc = targets[i];
-        BOOST_FOREACH(TVar vLive, data.blocks[bbSrc].gen) {
-            live.insert(vLive);
-            if (multipleTargets)
-                livePerTarget[i].insert(vLive);
-        }
+        const TBits &liveSrc = data.bits[bits.succs[i]].gen;
+        live |= liveSrc;
+        if (multipleTargets)
+            livePerTarget[i] = liveSrc;
     }
 
     if (cntTargets == 0) {
         // make sure those variables are left *live* when going out of function
         BOOST_FOREACH(TAliasMap::const_reference ref, data.derefAliases)
-            live.insert(ref.second);
+            live.set(varIdxOf(data, ref.second));
     }
 
     // go backwards through the instructions
@@ -470,36 +576,26 @@ void commitBlock(Data &data, TBlock bb)
     // finish this block -- there may stay some variables that are untouched by
     // this block and/but these are alive only for some of targets --> lets
     // catch these these fugitives.
-
-    TSet::const_iterator liveIt, perTargetIt;
     for (unsigned target = 0; target < cntTargets; ++target) {
-        TLivePerTarget::const_reference perTarget = livePerTarget[target];
-
-        liveIt = live.begin();
-        perTargetIt = perTarget.begin();
-
-        // complexity O(N) (N is number of variables in live).  Note that this
-        // needs the 'live' and 'livePerTarget' lists to be sorted
-        while (liveIt != live.end() && perTarget.end() != perTargetIt) {
+        const TBits &perTarget = livePerTarget[target];
 
-            int uidLive = *liveIt;
-            int uidPerTarget = *perTargetIt;
-
-            if (uidPerTarget < uidLive) {
-                // uidPerTarget is killed for particular target
-                ++perTargetIt;
-                continue;
-            }
+        // only the variables numbered below the last one live for the target
+        // are considered (as the former merge of sorted lists did)
+        TBits::size_type last = perTarget.find_first();
+        for (TBits::size_type idx = last; TBits::npos != idx;
+                idx = perTarget.find_next(idx))
+            last = idx;
 
-            else if (uidLive == uidPerTarget) {
-                ++perTargetIt;
-                ++liveIt;
-                continue;
-            }
+        if (TBits::npos == last)
+            continue;
 
-            // OK, now we have untouched variable 'uidLive'
-            killVariablePerTarget(data, bb, target, uidLive);
-            ++liveIt;
+        const TBits fugitives = live - perTarget;
+        for (TBits::size_type idx = fugitives.find_first();
+                TBits::npos != idx && idx < last;
+                idx = fugitives.find_next(idx))
+        {
+            // OK, now we have untouched variable
+            killVariablePerTarget(data, bb, target, data.varByIdx[idx]);
         }
     }
 }
@@ -592,7 +688,7 @@ void presetLive(Data &data, const TBlock bb)
             bData.gen.insert(pair.second);
 }
 
-void analyzeFnc(Fnc &fnc)
+void analyzeFnc(Fnc &fnc, float *pTimeFixPoint)
 {
     // shared state info
     Data data(*fnc.stor);
@@ -600,7 +696,6 @@ void analyzeFnc(Fnc &fnc)
 
     TLoc loc = &fnc.def.data.cst.data.cst_fnc.loc;
     VK_DEBUG_MSG(2, loc, ">>> entering " << nameOf(fnc) << "()");
-    CL_BREAK_IF(!data.todo.empty());
 
     // pre-compute dereferences
     findAliases(data, fnc);
@@ -617,18 +712,21 @@ void analyzeFnc(Fnc &fnc)
 
         // guarantee to distribute pointer-targests exist when function finishes
         presetLive(data, bb);
-
-        data.todo.insert(bb);
     }
 
     // compute a fixed-point for a single function
     VK_DEBUG_MSG(2, loc, "computing fixed-point for " << nameOf(fnc) << "()");
+    StopWatch watch;
+    numberBlocks(data, fnc.cfg);
+    numberVars(data);
+    buildBits(data);
     computeFixPoint(data);
+    *pTimeFixPoint += watch.elapsed();
 
     // commit the results
     BOOST_FOREACH(const TBlock bb, fnc.cfg) {
         VK_DEBUG_MSG(2, &bb->front()->loc, "commitBlock: " << bb->name());
-        commitBlock(data, bb);
+        commitBlock(data, data.blockIdx[bb]);
     }
 }
 
@@ -637,6 +735,7 @@ void analyzeFnc(Fnc &fnc)
 void killLocalVariables(Storage &stor)
 {
     StopWatch watch;
+    float timeFixPoint = 0.0;
 
     // analyze all _defined_ functions
     BOOST_FOREACH(Fnc *pFnc, stor.fncs) {
@@ -645,7 +744,7 @@ void killLocalVariables(Storage &stor)
             continue;
 
         // analyze a single function
-        VarKiller::analyzeFnc(fnc);
+        VarKiller::analyzeFnc(fnc, &timeFixPoint);
     }
 
     VarKiller::PTStats *stats = VarKiller::PTStats::getInstance();
@@ -654,7 +753,9 @@ void killLocalVariables(Storage &stor)
                 << "/" << stats->fullCount << " variables by PointsTo");
     }
 
-    CL_DEBUG("killLocalVariables() took " << watch);
+    CL_DEBUG("killLocalVariables() took " << watch
+            << " (fixed-point computation " << std::fixed
+            << std::setprecision(3) << timeFixPoint << " s)");
 }
 
 } // namespace CodeStorage
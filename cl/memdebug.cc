@@ -21,6 +21,7 @@
 
 #include <cl/cl_msg.hh>
 #include <cl/memdebug.hh>
+#include <cl/mempool.hh>
 
 #include <iomanip>
 
@@ -116,6 +117,7 @@ bool printMemUsage(const char *fnc)
                 /* dec digits */ 2)
             << " MB (just completed " << fnc << "())");
 
+    printMemPoolStats();
     return true;
 }
 
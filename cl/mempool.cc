@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "config_cl.h"
+
+#include <cl/cl_msg.hh>
+#include <cl/mempool.hh>
+
+#include <iomanip>
+
+// all block sizes are rounded up to a multiple of this (keeps the alignment)
+static const size_t poolGranularity = 16U;
+
+// larger blocks are passed through to the global operator new
+static const size_t poolMaxBlockSize = 512U;
+
+// count of size classes served by the pool
+static const size_t poolCntClasses = poolMaxBlockSize / poolGranularity;
+
+// amount of memory requested from the system at once
+static const size_t poolSlabSize = 64U << /* KiB */ 10;
+
+struct FreeBlock {
+    FreeBlock                  *next;
+};
+
+// intentionally a POD with no destructor, blocks may be released as late as
+// on destruction of other static objects
+static struct {
+    FreeBlock                  *freeList[poolCntClasses];
+    char                       *slabCursor;
+    size_t                      slabLeft;
+
+    // statistics
+    size_t                      cntAlloc;
+    size_t                      cntFree;
+    size_t                      cntRecycled;
+    size_t                      cntOversized;
+    size_t                      cntSlabs;
+    size_t                      bytesInUse;
+    size_t                      bytesPeak;
+} pool;
+
+static inline size_t sizeClassOf(const size_t size)
+{
+    // zero-sized requests still need a unique address
+    return (size + poolGranularity - 1U) / poolGranularity - !!size;
+}
+
+void* poolAlloc(const size_t size)
+{
+    if (poolMaxBlockSize < size) {
+        ++pool.cntOversized;
+        return ::operator new(size);
+    }
+
+    const size_t idx = sizeClassOf(size);
+    const size_t blockSize = (idx + 1U) * poolGranularity;
+
+    ++pool.cntAlloc;
+    pool.bytesInUse += blockSize;
+    if (pool.bytesPeak < pool.bytesInUse)
+        pool.bytesPeak = pool.bytesInUse;
+
+    FreeBlock *&head = pool.freeList[idx];
+    if (head) {
+        // recycle a previously released block
+        ++pool.cntRecycled;
+        FreeBlock *block = head;
+        head = block->next;
+        return block;
+    }
+
+    if (pool.slabLeft < blockSize) {
+        // the tail of the current slab (if any) is wasted intentionally
+        pool.slabCursor = static_cast<char *>(::operator new(poolSlabSize));
+        pool.slabLeft = poolSlabSize;
+        ++pool.cntSlabs;
+    }
+
+    void *block = pool.slabCursor;
+    pool.slabCursor += blockSize;
+    pool.slabLeft -= blockSize;
+    return block;
+}
+
+void poolFree(void *ptr, const size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (poolMaxBlockSize < size) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const size_t idx = sizeClassOf(size);
+    ++pool.cntFree;
+    pool.bytesInUse -= (idx + 1U) * poolGranularity;
+
+    FreeBlock *block = static_cast<FreeBlock *>(ptr);
+    FreeBlock *&head = pool.freeList[idx];
+    block->next = head;
+    head = block;
+}
+
+static inline float toMiB(const size_t bytes)
+{
+    return static_cast<float>(bytes) / static_cast<float>(1U << /* MiB */ 20);
+}
+
+bool printMemPoolStats()
+{
+    if (!pool.cntAlloc && !pool.cntOversized)
+        // the pool has not been used at all
+        return false;
+
+    const size_t bytesReserved = pool.cntSlabs * poolSlabSize;
+
+    using namespace std;
+    CL_DEBUG("pool allocator: "
+            << (pool.cntAlloc - pool.cntFree) << " blocks live, "
+            << pool.cntAlloc << " allocated (" << pool.cntRecycled
+            << " recycled, " << pool.cntOversized << " oversized), "
+            << fixed << setprecision(2)
+            << toMiB(pool.bytesInUse) << " MB in use, "
+            << toMiB(pool.bytesPeak) << " MB peak, "
+            << toMiB(bytesReserved) << " MB reserved");
+
+    return true;
+}
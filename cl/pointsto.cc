@@ -33,11 +33,15 @@
 #include <cl/clutil.hh>
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 #include <boost/foreach.hpp>
 
 int pt_dbg_level = CL_DEBUG_POINTS_TO;
 
+thread_local std::vector<std::string> *ptMsgBuffer;
+
 namespace CodeStorage {
 
 namespace PointsTo {
@@ -555,6 +559,14 @@ static void ptParseOpts(BuildCtx &ctx, const char *ptr)
             PT_DEBUG(0, "Request for plotting PT-graph when graph changed.");
             ctx.plot.progress = "points-to-progress";
         }
+        else if (0 == strncmp(option, "jobs=", sizeof "jobs=" - 1)) {
+            ctx.jobs = atoi(option + sizeof "jobs=" - 1);
+            if (ctx.jobs < 1) {
+                PT_ERROR("Bad number of jobs '" << option << "'");
+                ctx.jobs = 1;
+            }
+            PT_DEBUG(0, "Using " << ctx.jobs << " jobs for FICS.");
+        }
         else
             PT_ERROR("Bad argument '" << option << "'");
     }
@@ -26,11 +26,34 @@
 #include <cl/cl_msg.hh>
 #include <cl/cldebug.hh>
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 extern int pt_dbg_level;
 
+/**
+ * if not NULL, PT_DEBUG() records the messages of the current thread here
+ * instead of emitting them, formatted the same way as CL_DEBUG() would do
+ */
+extern thread_local std::vector<std::string> *ptMsgBuffer;
+
 #define PT_DEBUG(level, ...) do {                                           \
-    if ((level) <= pt_dbg_level)                                            \
+    if ((level) > pt_dbg_level)                                             \
+        break;                                                              \
+                                                                            \
+    if (!ptMsgBuffer) {                                                     \
         CL_DEBUG("PT: " << __VA_ARGS__);                                    \
+        break;                                                              \
+    }                                                                       \
+                                                                            \
+    if (!cl_debug_level())                                                  \
+        break;                                                              \
+                                                                            \
+    std::ostringstream str;                                                 \
+    str << __FILE__ << ":" << __LINE__ << ": debug: PT: " << __VA_ARGS__    \
+        << " [internal location]";                                          \
+    ptMsgBuffer->push_back(str.str());                                      \
 } while (0)
 
 // this does not force invocation of gcc error
@@ -69,9 +92,19 @@ namespace PointsTo {
                 int phases;
             } debug;
 
+            // number of worker threads used in phases 2 and 3 of FICS (the
+            // functions are processed one by one when set to 1)
+            int                         jobs;
+
+            // where to report that the analysis gave up, &stor.ptd.dead
+            // unless running on a worker thread of FICS
+            bool                       *pDead;
+
             BuildCtx(Storage &stor_) :
                 stor(stor_),
-                ptg(NULL)
+                ptg(NULL),
+                jobs(1),
+                pDead(&stor_.ptd.dead)
             {
                 plot.progress = NULL; // disable by default
                 debug.phases = FICS_PHASE_1 | FICS_PHASE_2 | FICS_PHASE_3;
@@ -28,6 +28,14 @@
 #include "pointsto.hh"
 #include "pointsto_fics.hh"
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <boost/foreach.hpp>
 
 template <class T>
@@ -195,8 +203,12 @@ int generateMallocUid(const Insn *insn)
 {
     static int i = 0;
     static std::map<const Insn *, int> ids;
-    if (hasKey(ids, insn))
-        return ids[insn];
+
+    // parallelPhase2() assigns all the uids in advance, so that the concurrent
+    // calls only read the map
+    const std::map<const Insn *, int>::const_iterator it = ids.find(insn);
+    if (ids.end() != it)
+        return it->second;
 
     ids[insn] = ++i;
     return i;
@@ -449,7 +461,7 @@ RetVal phase1handleInsn(
     return PTFICS_RET_CHANGE;
 
 fallback:
-    ctx.stor.ptd.dead = 1;
+    *ctx.pDead = true;
     return PTFICS_RET_FAIL;
 }
 
@@ -1024,7 +1036,7 @@ bool bindLocations(
 {
     if (srcPtg == tgtPtg) {
         PT_DEBUG(0, "recursion detected, giving up...");
-        ctx.stor.ptd.dead = true;
+        *ctx.pDead = true;
         return false;
     }
 
@@ -1158,6 +1170,423 @@ void scheduleTopologically(TWl &dst, const CallGraph::Graph &cg)
     }
 }
 
+/**
+ * shape the graph of 'caller' based on graphs of all functions it calls (the
+ * first half of one step of phase 2)
+ */
+RetVal bindCalls(BuildCtx &ctx, Fnc *caller)
+{
+    bool change = false;
+    ctx.ptg = &caller->ptg;
+    CallGraph::Node *cgNode = caller->cgNode;
+
+    // all calling functions should be shaped based on 'caller' function
+    BOOST_FOREACH(TInsnListByFnc::const_reference item, cgNode->calls) {
+        const Fnc *callee = item.first;
+        if (!callee)
+            // indirect function call
+            FALLBACK("TODO: indirect call");
+
+        if (isBuiltInFnc(callee->def))
+            continue;
+
+        // all calls of 'callee' may change shape of callee's graph
+        const TInsnList &calls = item.second;
+        BOOST_FOREACH(const Insn *insn, calls) {
+            // so let's shape the graph of 'callee'
+            RetVal rc = bind(ctx, insn, caller, callee);
+            if (PTFICS_RET_FAIL == rc)
+                FALLBACK("bind failed");
+            if (PTFICS_RET_CHANGE == rc)
+                change = true;
+        }
+    }
+
+    return change ? PTFICS_RET_CHANGE : PTFICS_RET_NO_CHANGE;
+
+fallback:
+    return PTFICS_RET_FAIL;
+}
+
+/**
+ * shape the global graph based on the graph of 'caller' (the second half of
+ * one step of phase 2)
+ */
+RetVal bindGlobals(BuildCtx &ctx, Fnc *caller)
+{
+    bool change = false;
+    ctx.ptg = &caller->ptg;
+
+    // shape the Global points-to graph based on 'caller's one
+    RetVal rv = bindGlobal(ctx);
+    if (PTFICS_RET_FAIL == rv)
+        FALLBACK("BindGlobal failed");
+    if (PTFICS_RET_CHANGE == rv)
+        change = true;
+
+    // push the global aliases from caller into global points-to graph
+    if (bindLocationsGlob(ctx, ctx.ptg /* src */, &ctx.stor.ptd.gptg /* tgt */))
+        change = true;
+
+    return change ? PTFICS_RET_CHANGE : PTFICS_RET_NO_CHANGE;
+
+fallback:
+    return PTFICS_RET_FAIL;
+}
+
+/**
+ * push the alias information from the global graph and from graphs of all
+ * calling functions into the graph of 'callee' (one step of phase 3)
+ */
+RetVal bindCallers(BuildCtx &ctx, Fnc *callee)
+{
+    bool change = false;
+    // push the alias info from global PT-graph to graph of handled fnc
+    if (bindLocationsGlob(ctx, &ctx.stor.ptd.gptg, &callee->ptg))
+        change = true;
+    CallGraph::Node *cgNode = callee->cgNode;
+
+    // go through all functions calling the 'callee' one
+    BOOST_FOREACH(TInsnListByFnc::const_reference item, cgNode->callers) {
+        Fnc *caller = item.first;
+
+        BOOST_FOREACH(const Insn *insn, item.second) {
+            TBindPairs pairs;
+            if (bindPairs(insn, pairs))
+                FALLBACK("binding operands -> parameters");
+
+            if (bindLocationsArgs(ctx, pairs, &caller->ptg, &callee->ptg))
+                change = true;
+        }
+    }
+
+    return change ? PTFICS_RET_CHANGE : PTFICS_RET_NO_CHANGE;
+
+fallback:
+    return PTFICS_RET_FAIL;
+}
+
+typedef enum {
+    FICS_TASK_CALLS = 0,                ///< bindCalls()
+    FICS_TASK_GLOBALS,                  ///< bindGlobals()
+    FICS_TASK_CALLERS                   ///< bindCallers()
+} TTaskCode;
+
+/// one step of phase 2 or 3 to be run by TaskRunner
+struct FicsTask {
+    TTaskCode                           code;
+    Fnc                                *fnc;
+
+    /// tasks that may not start before this one has finished
+    std::vector<int>                    succs;
+
+    /// number of not yet finished tasks this one waits for
+    int                                 preds;
+
+    FicsTask(TTaskCode code_, Fnc *fnc_):
+        code(code_),
+        fnc(fnc_),
+        preds(0)
+    {
+    }
+};
+
+typedef std::vector<FicsTask>           TTaskList;
+typedef std::vector<const Graph *>      TGraphList;
+
+/**
+ * Order the tasks that access the same graph the way they would be executed
+ * by the serial algorithm.  The tasks are given in the serial order and two of
+ * them are ordered iff one of them changes a graph the other one accesses.
+ * Each of the tasks is executed exactly once, the tasks without a dependency
+ * between them do not share any changed graph, so any run that respects the
+ * dependencies computes the very same graphs as the serial one.
+ */
+class TaskPlanner {
+    public:
+        TaskPlanner(TTaskList &tasks):
+            tasks_(tasks)
+        {
+        }
+
+        void addTask(
+                const FicsTask             &task,
+                const TGraphList           &reads,
+                const Graph                *write)
+        {
+            const int idx = tasks_.size();
+            tasks_.push_back(task);
+
+            BOOST_FOREACH(const Graph *ptg, reads)
+                if (ptg != write) {
+                    this->dependOn(lastWriter(ptg), idx);
+                    readers_[ptg].push_back(idx);
+                }
+
+            this->dependOn(lastWriter(write), idx);
+            BOOST_FOREACH(int reader, readers_[write])
+                this->dependOn(reader, idx);
+
+            readers_[write].clear();
+            writers_[write] = idx;
+        }
+
+    private:
+        int lastWriter(const Graph *ptg) const {
+            std::map<const Graph *, int>::const_iterator it =
+                writers_.find(ptg);
+
+            return (writers_.end() == it)
+                ? -1
+                : it->second;
+        }
+
+        void dependOn(int pred, int succ) {
+            if (-1 == pred || pred == succ)
+                return;
+
+            std::vector<int> &succs = tasks_[pred].succs;
+            if (!succs.empty() && succs.back() == succ)
+                // already there
+                return;
+
+            succs.push_back(succ);
+            tasks_[succ].preds++;
+        }
+
+    private:
+        TTaskList                                  &tasks_;
+        std::map<const Graph *, int>                writers_;
+        std::map<const Graph *, std::vector<int> >  readers_;
+};
+
+/**
+ * run the tasks on ctx.jobs threads in an order respecting their dependencies,
+ * the outcome (including the debug output) is the same as if the tasks were
+ * run one by one in the serial order until the first failure
+ */
+class TaskRunner {
+    public:
+        TaskRunner(BuildCtx &ctx, TTaskList &tasks):
+            ctx_(ctx),
+            tasks_(tasks),
+            msgs_(tasks.size()),
+            failedIdx_(tasks.size()),
+            running_(0U),
+            dead_(false)
+        {
+            for (unsigned i = 0; i < tasks_.size(); ++i)
+                if (!tasks_[i].preds)
+                    ready_.insert(i);
+        }
+
+        /// return false if any of the tasks has failed
+        bool run() {
+            std::vector<std::thread> workers;
+            for (int i = 0; i < ctx_.jobs; ++i)
+                workers.push_back(std::thread(&TaskRunner::work, this));
+
+            BOOST_FOREACH(std::thread &worker, workers)
+                worker.join();
+
+            // the workers are gone, nobody else touches the flag now
+            if (dead_)
+                *ctx_.pDead = true;
+
+            // flush the messages of the tasks the serial run would execute
+            for (unsigned idx = 0; idx < tasks_.size(); ++idx) {
+                BOOST_FOREACH(const std::string &msg, msgs_[idx])
+                    cl_debug(msg.c_str());
+
+                if (idx == failedIdx_)
+                    break;
+            }
+
+            return (tasks_.size() == failedIdx_);
+        }
+
+    private:
+        /// true if a task preceding the first failed one is ready to run
+        bool hasWork() const {
+            return !ready_.empty()
+                && *ready_.begin() < failedIdx_;
+        }
+
+        void work() {
+            // each worker needs its own scratch space for joining of nodes
+            BuildCtx ctx(ctx_);
+            ctx.joinTodo.clear();
+
+            // collect the flag locally, it is merged in run() after join
+            bool dead = false;
+            ctx.pDead = &dead;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                while (!hasWork() && running_)
+                    cond_.wait(lock);
+
+                if (!hasWork())
+                    // nothing more to do in the serial order
+                    break;
+
+                // pick the ready task which comes first in the serial order
+                const unsigned idx = *ready_.begin();
+                ready_.erase(ready_.begin());
+                ++running_;
+
+                lock.unlock();
+                ptMsgBuffer = &msgs_[idx];
+                const bool ok = (PTFICS_RET_FAIL != runTask(ctx, idx));
+                ptMsgBuffer = NULL;
+                lock.lock();
+
+                --running_;
+                if (!ok && idx < failedIdx_)
+                    failedIdx_ = idx;
+
+                BOOST_FOREACH(int succ, tasks_[idx].succs)
+                    if (!--tasks_[succ].preds)
+                        ready_.insert(succ);
+
+                cond_.notify_all();
+            }
+
+            if (dead)
+                dead_ = true;
+        }
+
+        RetVal runTask(BuildCtx &ctx, int idx) {
+            const FicsTask &task = tasks_[idx];
+            switch (task.code) {
+                case FICS_TASK_CALLS:
+                    return bindCalls(ctx, task.fnc);
+
+                case FICS_TASK_GLOBALS:
+                    return bindGlobals(ctx, task.fnc);
+
+                case FICS_TASK_CALLERS:
+                    return bindCallers(ctx, task.fnc);
+            }
+
+            CL_BREAK_IF("invalid call of TaskRunner::runTask()");
+            return PTFICS_RET_FAIL;
+        }
+
+    private:
+        typedef std::vector<std::string>            TMsgList;
+
+        BuildCtx                   &ctx_;
+        TTaskList                  &tasks_;
+        std::vector<TMsgList>       msgs_;
+        std::mutex                  mutex_;
+        std::condition_variable     cond_;
+        std::set<unsigned>          ready_;
+        unsigned                    failedIdx_;
+        unsigned                    running_;
+        bool                        dead_;
+};
+
+/// return true if the functions of phases 2 and 3 may be processed in parallel
+bool canRunParallel(const BuildCtx &ctx)
+{
+    if (ctx.jobs < 2)
+        return false;
+
+    // plotting and debugging output would interleave arbitrarily
+    return !ctx.plot.progress
+        && pt_dbg_level < 1;
+}
+
+/// parallel variant of ficsPhase2() computing the very same graphs
+bool parallelPhase2(BuildCtx &ctx)
+{
+    TStorRef stor = ctx.stor;
+    TTaskList tasks;
+    TaskPlanner planner(tasks);
+    const Graph *gptg = &stor.ptd.gptg;
+
+    BOOST_FOREACH(const Fnc *pFnc, stor.callGraph.topOrder) {
+        Fnc *caller = const_cast<Fnc *>(pFnc);
+        if (isBuiltInFnc(caller->def) || isWhiteListed(caller))
+            continue;
+
+        TGraphList reads;
+        BOOST_FOREACH(TInsnListByFnc::const_reference item,
+                caller->cgNode->calls)
+        {
+            const Fnc *callee = item.first;
+            if (!callee || isBuiltInFnc(callee->def))
+                continue;
+
+            reads.push_back(&callee->ptg);
+
+            // the uids of heap objects are assigned in the serial order
+            BOOST_FOREACH(const Insn *insn, item.second) {
+                TBindPairs pairs;
+                if (isWhiteListed(insn))
+                    isKnownModel(insn, pairs);
+            }
+        }
+
+        planner.addTask(FicsTask(FICS_TASK_CALLS, caller), reads,
+                &caller->ptg);
+
+        reads.clear();
+        reads.push_back(&caller->ptg);
+        planner.addTask(FicsTask(FICS_TASK_GLOBALS, caller), reads, gptg);
+    }
+
+    PT_DEBUG(1, "running " << tasks.size() << " tasks on "
+            << ctx.jobs << " threads");
+
+    TaskRunner runner(ctx, tasks);
+    if (runner.run())
+        return true;
+
+    stor.ptd.dead = true;
+    return false;
+}
+
+/// return true if any function calls itself directly
+bool hasSelfCall(const CallGraph::Graph &cg)
+{
+    BOOST_FOREACH(const Fnc *fnc, cg.topOrder)
+        if (hasKey(fnc->cgNode->calls, const_cast<Fnc *>(fnc)))
+            return true;
+
+    return false;
+}
+
+/// parallel variant of ficsPhase3() computing the very same graphs
+bool parallelPhase3(BuildCtx &ctx)
+{
+    TStorRef stor = ctx.stor;
+    TTaskList tasks;
+    TaskPlanner planner(tasks);
+
+    BOOST_FOREACH(const Fnc *pFnc, stor.callGraph.topOrder) {
+        Fnc *callee = const_cast<Fnc *>(pFnc);
+        if (isBuiltInFnc(callee->def) || isWhiteListed(callee))
+            continue;
+
+        TGraphList reads;
+        reads.push_back(&stor.ptd.gptg);
+        BOOST_FOREACH(TInsnListByFnc::const_reference item,
+                callee->cgNode->callers)
+        {
+            const Fnc *caller = item.first;
+            reads.push_back(&caller->ptg);
+        }
+
+        planner.addTask(FicsTask(FICS_TASK_CALLERS, callee), reads,
+                &callee->ptg);
+    }
+
+    TaskRunner runner(ctx, tasks);
+    return runner.run();
+}
+
 bool ficsPhase2(BuildCtx &ctx)
 {
     TStorRef stor = ctx.stor;
@@ -1169,6 +1598,9 @@ bool ficsPhase2(BuildCtx &ctx)
         return true;
     }
 
+    if (canRunParallel(ctx))
+        return parallelPhase2(ctx);
+
     // pre-plan to explore all functions
     scheduleTopologically(fp, stor.callGraph);
 
@@ -1176,47 +1608,24 @@ bool ficsPhase2(BuildCtx &ctx)
     while (fp.next(caller)) {
         PT_DEBUG(1, "processing '" << nameOf(*caller) << "'");
         bool change = false;
-        ctx.ptg = &caller->ptg;
-        CallGraph::Node *cgNode = caller->cgNode;
 
-        // all calling functions should be shaped based on 'caller' function
-        BOOST_FOREACH(TInsnListByFnc::const_reference item, cgNode->calls) {
-            const Fnc *callee = item.first;
-            if (!callee)
-                // indirect function call
-                FALLBACK("TODO: indirect call");
-
-            if (isBuiltInFnc(callee->def))
-                continue;
-
-            // all calls of 'callee' may change shape of callee's graph
-            const TInsnList &calls = item.second;
-            BOOST_FOREACH(const Insn *insn, calls) {
-                // so let's shape the graph of 'callee'
-                RetVal rc = bind(ctx, insn, caller, callee);
-                if (PTFICS_RET_FAIL == rc)
-                    FALLBACK("bind failed");
-                if (PTFICS_RET_CHANGE == rc)
-                    change = true;
-            }
-        }
-
-        // shape the Global points-to graph based on 'caller's one
-        RetVal rv = bindGlobal(ctx);
+        RetVal rv = bindCalls(ctx, caller);
         if (PTFICS_RET_FAIL == rv)
-            FALLBACK("BindGlobal failed");
+            goto fallback;
         if (PTFICS_RET_CHANGE == rv)
             change = true;
 
-        // push the global aliases from caller into global points-to graph
-        if (bindLocationsGlob(ctx, ctx.ptg /* src */, &stor.ptd.gptg /* tgt */))
+        rv = bindGlobals(ctx, caller);
+        if (PTFICS_RET_FAIL == rv)
+            goto fallback;
+        if (PTFICS_RET_CHANGE == rv)
             change = true;
 
         if (!change)
             continue;
 
         // plan successors to process again when something changed in caller
-        BOOST_FOREACH(TInsnListByFnc::reference item, cgNode->calls) {
+        BOOST_FOREACH(TInsnListByFnc::reference item, caller->cgNode->calls) {
             Fnc *cld = item.first;
             if (isBuiltInFnc(cld->def) || isWhiteListed(cld))
                 continue;
@@ -1243,34 +1652,24 @@ bool ficsPhase3(BuildCtx &ctx)
         return true;
     }
 
+    // giving up on direct recursion is left to the serial algorithm
+    if (canRunParallel(ctx) && !hasSelfCall(stor.callGraph))
+        return parallelPhase3(ctx);
+
     // plan to explore all functions we are interested in
     scheduleTopologically(fp, stor.callGraph);
 
     Fnc *callee;
     while (!stor.ptd.dead && fp.next(callee)) {
-        bool change = false;
-        // push the alias info from global PT-graph to graph of handled fnc
-        if (bindLocationsGlob(ctx, &stor.ptd.gptg, &callee->ptg))
-            change = true;
-        CallGraph::Node *cgNode = callee->cgNode;
-
-        // go through all functions calling the 'callee' one
-        BOOST_FOREACH(TInsnListByFnc::const_reference item, cgNode->callers) {
-            Fnc *caller = item.first;
-
-            BOOST_FOREACH(const Insn *insn, item.second) {
-                TBindPairs pairs;
-                if (bindPairs(insn, pairs))
-                    FALLBACK("binding operands -> parameters");
-
-                if (bindLocationsArgs(ctx, pairs, &caller->ptg, &callee->ptg))
-                    change = true;
-            }
-        }
+        RetVal rv = bindCallers(ctx, callee);
+        if (PTFICS_RET_FAIL == rv)
+            return false;
 
-        if (change) {
+        if (PTFICS_RET_CHANGE == rv) {
             // plan to re-visit all successors
-            BOOST_FOREACH(TInsnListByFnc::reference item, cgNode->calls) {
+            BOOST_FOREACH(TInsnListByFnc::reference item,
+                    callee->cgNode->calls)
+            {
                 Fnc *cld = item.first;
                 if (isBuiltInFnc(cld->def) || isWhiteListed(cld))
                     continue;
@@ -1281,9 +1680,6 @@ bool ficsPhase3(BuildCtx &ctx)
 
     PT_DEBUG(2, "fixpoint reached in " << fp.steps() << " steps");
     return true;
-
-fallback:
-    return false;
 }
 
 bool runFICS(BuildCtx &ctx)
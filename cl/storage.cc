@@ -23,6 +23,7 @@
 #include <cl/cl_msg.hh>
 
 #include "cl_storage.hh"
+#include "uidindex.hh"
 #include "util.hh"
 
 #include <map>
@@ -34,6 +35,35 @@
 namespace CodeStorage {
 
 namespace {
+    template <class TKey, class TArg>
+    bool indexFind(unsigned *pIdx, const std::map<TKey, unsigned> &db,
+                   const TArg &key)
+    {
+        typename std::map<TKey, unsigned>::const_iterator iter = db.find(key);
+        if (db.end() == iter)
+            return false;
+
+        *pIdx = iter->second;
+        return true;
+    }
+
+    template <class TKey, class TArg>
+    void indexInsert(std::map<TKey, unsigned> &db, const TArg &key,
+                     unsigned idx)
+    {
+        db[key] = idx;
+    }
+
+    bool indexFind(unsigned *pIdx, const UidIndex &db, int uid)
+    {
+        return db.find(pIdx, uid);
+    }
+
+    void indexInsert(UidIndex &db, int uid, unsigned idx)
+    {
+        db.insert(uid, idx);
+    }
+
     /**
      * Look for an existing value, create a new one if not found.
      * @param db Mapping from key to index.
@@ -47,14 +77,14 @@ namespace {
              const typename TTab::value_type &tpl
                  = typename TTab::value_type())
     {
-        typename TDb::iterator iter = db.find(key);
-        if (db.end() != iter)
+        unsigned idx;
+        if (indexFind(&idx, db, key))
             // key found
-            return idxTab[iter->second];
+            return idxTab[idx];
 
         // allocate a new item
-        unsigned idx = idxTab.size();
-        db[key] = idx;
+        idx = idxTab.size();
+        indexInsert(db, key, idx);
         idxTab.push_back(tpl);
         return idxTab[idx];
     }
@@ -69,13 +99,13 @@ namespace {
     const typename TTab::value_type&
     dbConstLookup(const TDb &db, const TTab &idxTab, TKey key)
     {
-        typename TDb::const_iterator iter = db.find(key);
-        if (db.end() == iter) {
+        unsigned idx;
+        if (!indexFind(&idx, db, key)) {
             CL_BREAK_IF("can't insert anything into const object");
             return idxTab.front();
         }
 
-        return idxTab[iter->second];
+        return idxTab[idx];
     }
 }
 
@@ -159,8 +189,7 @@ bool isOnStack(const Var &var)
 // /////////////////////////////////////////////////////////////////////////////
 // VarDb implementation
 struct VarDb::Private {
-    typedef std::map<int, unsigned> TMap;
-    TMap db;
+    UidIndex db;
 };
 
 VarDb::VarDb():
@@ -179,20 +208,27 @@ VarDb::~VarDb()
 
 Var& VarDb::operator[](int uid)
 {
+    UID_TRACE("vl %d\n", uid);
     return dbLookup(d->db, vars_, uid);
 }
 
 const Var& VarDb::operator[](int uid) const
 {
+    UID_TRACE("vc %d\n", uid);
     return dbConstLookup(d->db, vars_, uid);
 }
 
+void VarDb::finalize()
+{
+    UID_TRACE("vz 0\n");
+    d->db.finalize();
+}
+
 
 // /////////////////////////////////////////////////////////////////////////////
 // TypeDb implementation
 struct TypeDb::Private {
-    typedef std::map<int, const struct cl_type *> TMap;
-    TMap db;
+    UidIndex db;
 
     int codePtrSizeof;
     int dataPtrSizeof;
@@ -252,15 +288,15 @@ bool TypeDb::insert(const struct cl_type *clt)
         return false;
     }
     const int uid = clt->uid;
+    UID_TRACE("tl %d\n", uid);
 
-    typedef Private::TMap TDb;
-    TDb &db = d->db;
-    TDb::iterator iter = db.find(uid);
-    if (db.end() != iter)
+    UidIndex &db = d->db;
+    unsigned idx;
+    if (db.find(&idx, uid))
         return false;
 
     // insert type into db
-    db[uid] = clt;
+    db.insert(uid, types_.size());
     types_.push_back(clt);
 
     d->digPtrSizeof(clt);
@@ -308,10 +344,10 @@ void readTypeTree(TypeDb &db, const struct cl_type *clt)
 
 const struct cl_type* TypeDb::operator[](int uid) const
 {
-    typedef Private::TMap TDb;
-    TDb &db = d->db;
-    TDb::iterator iter = db.find(uid);
-    if (db.end() == iter) {
+    UID_TRACE("tc %d\n", uid);
+
+    unsigned idx;
+    if (!d->db.find(&idx, uid)) {
         CL_DEBUG("TypeDb::insert() is unable to find the required cl_type: #"
                 << uid);
 
@@ -320,7 +356,13 @@ const struct cl_type* TypeDb::operator[](int uid) const
         return 0;
     }
 
-    return iter->second;
+    return types_[idx];
+}
+
+void TypeDb::finalize()
+{
+    UID_TRACE("tz 0\n");
+    d->db.finalize();
 }
 
 
@@ -567,8 +609,7 @@ bool isDefined(const Fnc &fnc)
 // /////////////////////////////////////////////////////////////////////////////
 // FncDb implementation
 struct FncDb::Private {
-    typedef std::map<int, unsigned> TMap;
-    TMap db;
+    UidIndex db;
 };
 
 FncDb::FncDb():
@@ -597,6 +638,7 @@ FncDb& FncDb::operator=(const FncDb &ref)
 
 Fnc*& FncDb::operator[](int uid)
 {
+    UID_TRACE("fl %d\n", uid);
     Fnc* &ref = dbLookup(d->db, fncs_, uid, 0);
     if (!ref)
         // the object will be NOT destroyed by FncDb
@@ -607,9 +649,16 @@ Fnc*& FncDb::operator[](int uid)
 
 const Fnc* FncDb::operator[](int uid) const
 {
+    UID_TRACE("fc %d\n", uid);
     return dbConstLookup(d->db, fncs_, uid);
 }
 
+void FncDb::finalize()
+{
+    UID_TRACE("fz 0\n");
+    d->db.finalize();
+}
+
 const Fnc* fncByCfg(const ControlFlow *pCfg)
 {
     const char *ptr = reinterpret_cast<const char *>(pCfg);
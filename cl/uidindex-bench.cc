@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file uidindex-bench.cc
+ * micro-benchmark replaying a trace of uid lookups in CodeStorage
+ *
+ * Build code listener with UID_TRACE_OPS enabled in uidindex.hh to record a
+ * trace while analyzing a test-case (e.g. one from predator-regre), then run
+ * 'uidindex-bench TRACE [ROUNDS]'.  The trace is replayed on both MapUidIndex
+ * and UidIndex, their answers are cross-checked, and the time spent by each of
+ * them is printed.
+ */
+
+#include "uidindex.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+enum EDb {
+    DB_VAR = 0,
+    DB_TYPE,
+    DB_FNC,
+    DB_CNT
+};
+
+struct TraceOp {
+    EDb                         db;
+    char                        code;   ///< 'l'ookup/insert, 'c'onst, 'z'
+    int                         uid;
+};
+
+typedef std::vector<TraceOp>                        TTrace;
+
+bool readTrace(TTrace *pDst, unsigned long cntOps[DB_CNT], FILE *fp)
+{
+    char db, code;
+    int uid;
+    while (3 == fscanf(fp, " %c%c %d", &db, &code, &uid)) {
+        TraceOp op;
+        op.code = code;
+        op.uid = uid;
+
+        switch (db) {
+            case 'v': op.db = DB_VAR;   break;
+            case 't': op.db = DB_TYPE;  break;
+            case 'f': op.db = DB_FNC;   break;
+            default:
+                code = 0;
+        }
+
+        if ('l' != code && 'c' != code && 'z' != code) {
+            std::cerr << "error: malformed trace near op #" << pDst->size()
+                << "\n";
+            return false;
+        }
+
+        ++cntOps[op.db];
+        pDst->push_back(op);
+    }
+
+    if (feof(fp))
+        return true;
+
+    std::cerr << "error: malformed trace near op #" << pDst->size() << "\n";
+    return false;
+}
+
+/// replay the trace, return a checksum of all the answers given by the indexes
+template <class TIndex>
+unsigned long replayTrace(const TTrace &trace)
+{
+    TIndex dbs[DB_CNT];
+    unsigned cnts[DB_CNT] = { 0U, 0U, 0U };
+    unsigned long sum = 0UL;
+
+    for (TTrace::const_iterator it = trace.begin(); trace.end() != it; ++it) {
+        const TraceOp &op = *it;
+        TIndex &db = dbs[op.db];
+
+        unsigned idx = static_cast<unsigned>(-1);
+        switch (op.code) {
+            case 'z':
+                db.finalize();
+                continue;
+
+            case 'l':
+                if (!db.find(&idx, op.uid)) {
+                    idx = cnts[op.db]++;
+                    db.insert(op.uid, idx);
+                }
+                break;
+
+            case 'c':
+                db.find(&idx, op.uid);
+                break;
+        }
+
+        sum = sum * 17UL + idx;
+    }
+
+    return sum;
+}
+
+template <class TIndex>
+unsigned long runBench(
+        const char                  *name,
+        const TTrace                &trace,
+        const int                   rounds)
+{
+    unsigned long sum = 0UL;
+    const clock_t start = clock();
+    for (int i = 0; i < rounds; ++i)
+        sum = replayTrace<TIndex>(trace);
+
+    const float elapsed = static_cast<float>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%-24s %10.3f s (checksum %lx)\n", name, elapsed, sum);
+    return sum;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || 3 < argc) {
+        std::cerr << "usage: " << argv[0] << " TRACE [ROUNDS]\n";
+        return EXIT_FAILURE;
+    }
+
+    FILE *fp = fopen(argv[1], "r");
+    if (!fp) {
+        std::cerr << "error: failed to open " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    TTrace trace;
+    unsigned long cntOps[DB_CNT] = { 0UL, 0UL, 0UL };
+    const bool ok = readTrace(&trace, cntOps, fp);
+    fclose(fp);
+    if (!ok)
+        return EXIT_FAILURE;
+
+    const int rounds = (3 == argc) ? atoi(argv[2]) : 1;
+    printf("replaying %lu var, %lu type, and %lu fnc lookups, %d round(s)\n",
+            cntOps[DB_VAR], cntOps[DB_TYPE], cntOps[DB_FNC], rounds);
+
+    const unsigned long sumMap =
+        runBench<MapUidIndex>("MapUidIndex", trace, rounds);
+
+    const unsigned long sumDense =
+        runBench<UidIndex>("UidIndex", trace, rounds);
+
+    if (sumMap == sumDense)
+        return EXIT_SUCCESS;
+
+    std::cerr << "error: the indexes gave different answers\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_UIDINDEX_H
+#define H_GUARD_UIDINDEX_H
+
+/**
+ * @file uidindex.hh
+ * mapping of uids of code listener objects to indexes of lookup tables
+ */
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+/**
+ * if 1, write all uid lookups of CodeStorage to UID_TRACE_FILE, such a trace
+ * can be replayed by the uidindex-bench program
+ */
+#define UID_TRACE_OPS                       0
+#define UID_TRACE_FILE                      "uidindex.trace"
+
+/**
+ * finalize() uses the dense table only if the range of uids is at most
+ * UID_DENSE_RATIO times bigger than the count of uids (plus UID_DENSE_SLACK)
+ */
+#define UID_DENSE_RATIO                     8
+#define UID_DENSE_SLACK                     0x400
+
+/// the original implementation, std::map lookup in O(log n) time
+class MapUidIndex {
+    private:
+        typedef std::map<int, unsigned>             TMap;
+        TMap                                        map_;
+
+    public:
+        /// return true and the index of uid in *pIdx if uid has been inserted
+        bool find(unsigned *pIdx, const int uid) const {
+            const TMap::const_iterator it = map_.find(uid);
+            if (map_.end() == it)
+                return false;
+
+            *pIdx = it->second;
+            return true;
+        }
+
+        /// bind the given index to uid, which must not be there yet
+        void insert(const int uid, const unsigned idx) {
+            map_[uid] = idx;
+        }
+
+        void finalize() {
+        }
+};
+
+/**
+ * Once finalize() is called, the uids are renumbered into a dense table that
+ * is indexed by (uid - base) in O(1) time.  If the uids are too sparse for the
+ * table to pay off, or a uid is inserted out of the range of the table later,
+ * the uid is looked up in std::map as before.
+ */
+class UidIndex {
+    private:
+        typedef std::map<int, unsigned>             TMap;
+        typedef std::vector<unsigned>               TTable;
+
+        static const unsigned NO_IDX = static_cast<unsigned>(-1);
+
+        /// uids out of the range of the dense table
+        TMap                                        map_;
+
+        /// indexes of uids starting at base_, NO_IDX for unused uids
+        TTable                                      table_;
+        int                                         base_;
+
+    public:
+        UidIndex():
+            base_(0)
+        {
+        }
+
+        /// return true and the index of uid in *pIdx if uid has been inserted
+        bool find(unsigned *pIdx, const int uid) const {
+            const unsigned long off = static_cast<long>(uid) - base_;
+            if (off < table_.size()) {
+                const unsigned idx = table_[off];
+                if (NO_IDX == idx)
+                    return false;
+
+                *pIdx = idx;
+                return true;
+            }
+
+            const TMap::const_iterator it = map_.find(uid);
+            if (map_.end() == it)
+                return false;
+
+            *pIdx = it->second;
+            return true;
+        }
+
+        /// bind the given index to uid, which must not be there yet
+        void insert(const int uid, const unsigned idx) {
+            const unsigned long off = static_cast<long>(uid) - base_;
+            if (off < table_.size())
+                table_[off] = idx;
+            else
+                map_[uid] = idx;
+        }
+
+        /// move the uids inserted so far into the dense table if it pays off
+        void finalize() {
+            if (map_.empty())
+                return;
+
+            const long lo = map_.begin()->first;
+            const long hi = map_.rbegin()->first;
+            const unsigned long cnt = map_.size() + this->cntDense();
+            const unsigned long range = (table_.empty())
+                ? hi - lo + 1L
+                : std::max(hi, base_ + static_cast<long>(table_.size()) - 1L)
+                    - std::min(lo, static_cast<long>(base_)) + 1L;
+
+            if (UID_DENSE_RATIO * cnt + UID_DENSE_SLACK < range)
+                // too sparse, keep using std::map
+                return;
+
+            TTable table(range, static_cast<unsigned>(NO_IDX));
+            const int base = (table_.empty())
+                ? lo
+                : std::min(lo, static_cast<long>(base_));
+
+            for (unsigned long off = 0UL; off < table_.size(); ++off)
+                table[base_ + off - base] = table_[off];
+
+            for (TMap::const_iterator it = map_.begin(); map_.end() != it; ++it)
+                table[it->first - base] = it->second;
+
+            table_.swap(table);
+            base_ = base;
+            map_.clear();
+        }
+
+    private:
+        unsigned long cntDense() const {
+            unsigned long cnt = 0UL;
+            for (TTable::const_iterator it = table_.begin();
+                    table_.end() != it; ++it)
+                if (NO_IDX != *it)
+                    ++cnt;
+
+            return cnt;
+        }
+};
+
+#if UID_TRACE_OPS
+#include <cstdio>
+
+inline FILE* uidTraceStream()
+{
+    static FILE *fp = fopen(UID_TRACE_FILE, "w");
+    return fp;
+}
+
+#   define UID_TRACE(...) do {                                              \
+        FILE *fp = uidTraceStream();                                        \
+        if (fp)                                                             \
+            fprintf(fp, __VA_ARGS__);                                       \
+    } while (0)
+#else
+#   define UID_TRACE(...) do { } while (0)
+#endif
+
+#endif /* H_GUARD_UIDINDEX_H */
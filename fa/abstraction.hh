@@ -21,6 +21,7 @@
 #define ABSTRACTION_H
 
 // Forester headers
+#include "bitmatrix.hh"
 #include "forestautext.hh"
 #include "streams.hh"
 
@@ -59,8 +60,7 @@ public:   // methods
 
 		Index<size_t> stateIndex;
 		fae_.getRoot(root)->buildStateIndex(stateIndex);
-		std::vector<std::vector<bool>> rel(stateIndex.size(),
-			std::vector<bool>(stateIndex.size(), true));
+		BitMatrix rel(stateIndex.size(), true);
 
 		// compute the abstraction (i.e. which states are to be merged)
 		fae_.getRoot(root)->heightAbstraction(rel, height, f, stateIndex);
@@ -113,8 +113,7 @@ public:   // methods
 		FA_NOTE("Index: " << faeStateIndex);
 
 		// create the initial relation
-		// TODO: use boost::dynamic_bitset
-		std::vector<std::vector<bool>> rel;
+		BitMatrix rel;
 
 		if (!predicates.empty())
 		{
@@ -140,7 +139,7 @@ public:   // methods
 			FA_NOTE("matchWith: " << oss.str());
 
 			// create the relation
-			rel.assign(numStates, std::vector<bool>(numStates, false));
+			rel.assign(numStates, false);
 			for (size_t i = 0; i < numStates; ++i)
 			{
 				rel[i][i] = true;
@@ -158,7 +157,7 @@ public:   // methods
 		else
 		{
 			// create universal relation
-			rel.assign(numStates, std::vector<bool>(numStates, true));
+			rel.assign(numStates, true);
 		}
 
 		for (size_t i = 0; i < fae_.getRootCount(); ++i)
@@ -86,7 +86,7 @@ public:
 
 public:
 
-	AntichainExt(const std::vector<std::vector<bool> >& rel) :
+	AntichainExt(const BitMatrix& rel) :
 		Antichain(rel),
 		aTransIndex{}
 	{ }
@@ -194,7 +194,7 @@ public:
 		for (size_t i = 0; i < cSize; ++i)
 			stateIndex.add(i);
 		// compute simulation
-		std::vector<std::vector<bool>> upsim, dwnsim, ident(cSize, std::vector<bool>(cSize, false));
+		BitMatrix upsim, dwnsim, ident(cSize, false);
 		for (size_t i = 0; i < cSize; ++i)
 		{
 			ident[i][i] = true;
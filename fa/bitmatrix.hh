@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BIT_MATRIX_H
+#define BIT_MATRIX_H
+
+// Standard library headers
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief  A dense square matrix of bits
+ *
+ * The matrix is stored row by row, each row padded to a whole number of
+ * machine words, so that operations on whole rows are carried out a word at a
+ * time.  It is used for relations over states of tree automata (simulations,
+ * collapse relations).  Padding bits are always kept zero.
+ */
+class BitMatrix
+{
+public:   // data types
+
+	typedef unsigned long Word;
+
+	static const size_t WORD_BITS = sizeof(Word) * CHAR_BIT;
+
+	/**
+	 * @brief  Reference to a single bit of the matrix
+	 */
+	class BitRef
+	{
+	private:  // data members
+
+		Word* word_;
+		Word mask_;
+
+	public:   // methods
+
+		BitRef(Word* word, Word mask) :
+			word_(word),
+			mask_(mask)
+		{ }
+
+		operator bool() const
+		{
+			return 0 != (*word_ & mask_);
+		}
+
+		BitRef& operator=(bool value)
+		{
+			if (value)
+				*word_ |= mask_;
+			else
+				*word_ &= ~mask_;
+
+			return *this;
+		}
+
+		BitRef& operator=(const BitRef& rhs)
+		{
+			return *this = static_cast<bool>(rhs);
+		}
+	};
+
+	/**
+	 * @brief  Read-only view of a row of the matrix
+	 */
+	class ConstRow
+	{
+	private:  // data members
+
+		const Word* words_;
+
+	public:   // methods
+
+		explicit ConstRow(const Word* words) :
+			words_(words)
+		{ }
+
+		bool operator[](size_t col) const
+		{
+			return 0 != (words_[col / WORD_BITS] & BitMatrix::maskOf(col));
+		}
+	};
+
+	/**
+	 * @brief  Writable view of a row of the matrix
+	 */
+	class Row
+	{
+	private:  // data members
+
+		Word* words_;
+
+	public:   // methods
+
+		explicit Row(Word* words) :
+			words_(words)
+		{ }
+
+		BitRef operator[](size_t col) const
+		{
+			return BitRef(&words_[col / WORD_BITS], BitMatrix::maskOf(col));
+		}
+	};
+
+private:  // data members
+
+	/// count of rows (and columns)
+	size_t size_;
+
+	/// count of words per row
+	size_t rowWords_;
+
+	/// the bits, row after row
+	std::vector<Word> data_;
+
+private:  // methods
+
+	static Word maskOf(size_t col)
+	{
+		return static_cast<Word>(1) << (col % WORD_BITS);
+	}
+
+	static size_t wordsFor(size_t size)
+	{
+		return (size + WORD_BITS - 1) / WORD_BITS;
+	}
+
+	/// the mask of valid bits in the last word of a row
+	Word lastWordMask() const
+	{
+		const size_t rest = size_ % WORD_BITS;
+		return (rest) ? ((static_cast<Word>(1) << rest) - 1) : ~static_cast<Word>(0);
+	}
+
+	Word* rowPtr(size_t row)
+	{
+		assert(row < size_);
+		return &data_[row * rowWords_];
+	}
+
+	const Word* rowPtr(size_t row) const
+	{
+		assert(row < size_);
+		return &data_[row * rowWords_];
+	}
+
+public:   // methods
+
+	explicit BitMatrix(size_t size = 0, bool value = false) :
+		size_(0),
+		rowWords_(0),
+		data_{}
+	{
+		this->assign(size, value);
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	/**
+	 * @brief  Sets the size of the matrix and fills all of it with @p value
+	 */
+	void assign(size_t size, bool value)
+	{
+		size_ = size;
+		rowWords_ = wordsFor(size);
+		data_.assign(size * rowWords_, 0);
+		if (value)
+		{
+			for (size_t i = 0; i < size; ++i)
+				this->fillRow(i, true);
+		}
+	}
+
+	/**
+	 * @brief  Changes the size of the matrix
+	 *
+	 * The bits in the common upper left corner are preserved, the new bits are
+	 * set to @p value.
+	 */
+	void resize(size_t size, bool value)
+	{
+		BitMatrix dst(size, value);
+		const size_t common = std::min(size, size_);
+		const size_t fullWords = common / WORD_BITS;
+		const size_t rest = common % WORD_BITS;
+		const Word restMask = (static_cast<Word>(1) << rest) - 1;
+		for (size_t i = 0; i < common; ++i)
+		{
+			Word* d = dst.rowPtr(i);
+			const Word* s = this->rowPtr(i);
+			std::copy(s, s + fullWords, d);
+			if (rest)
+				d[fullWords] = (d[fullWords] & ~restMask) | (s[fullWords] & restMask);
+		}
+
+		this->swap(dst);
+	}
+
+	void swap(BitMatrix& other)
+	{
+		std::swap(size_, other.size_);
+		std::swap(rowWords_, other.rowWords_);
+		data_.swap(other.data_);
+	}
+
+	Row operator[](size_t row)
+	{
+		return Row(this->rowPtr(row));
+	}
+
+	ConstRow operator[](size_t row) const
+	{
+		return ConstRow(this->rowPtr(row));
+	}
+
+	/**
+	 * @brief  Sets all bits of the row @p row to @p value
+	 */
+	void fillRow(size_t row, bool value)
+	{
+		Word* d = this->rowPtr(row);
+		if (!rowWords_)
+			return;
+
+		std::fill(d, d + rowWords_, (value) ? ~static_cast<Word>(0) : 0);
+		d[rowWords_ - 1] &= this->lastWordMask();
+	}
+
+	/**
+	 * @brief  Intersects the row @p row with the row @p srcRow of @p src
+	 */
+	void rowAnd(size_t row, const BitMatrix& src, size_t srcRow)
+	{
+		assert(src.size_ == size_);
+		Word* d = this->rowPtr(row);
+		const Word* s = src.rowPtr(srcRow);
+		for (size_t w = 0; w < rowWords_; ++w)
+			d[w] &= s[w];
+	}
+
+	/**
+	 * @brief  Unites the row @p row with the row @p srcRow of @p src
+	 */
+	void rowOr(size_t row, const BitMatrix& src, size_t srcRow)
+	{
+		assert(src.size_ == size_);
+		Word* d = this->rowPtr(row);
+		const Word* s = src.rowPtr(srcRow);
+		for (size_t w = 0; w < rowWords_; ++w)
+			d[w] |= s[w];
+	}
+
+	/**
+	 * @brief  Checks whether any bit of the row @p row is set
+	 */
+	bool rowAny(size_t row) const
+	{
+		const Word* s = this->rowPtr(row);
+		for (size_t w = 0; w < rowWords_; ++w)
+		{
+			if (s[w])
+				return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief  Checks whether the row @p row and the row @p otherRow of @p other
+	 *         have a common set bit
+	 */
+	bool rowsIntersect(size_t row, const BitMatrix& other, size_t otherRow) const
+	{
+		assert(other.size_ == size_);
+		const Word* s1 = this->rowPtr(row);
+		const Word* s2 = other.rowPtr(otherRow);
+		for (size_t w = 0; w < rowWords_; ++w)
+		{
+			if (s1[w] & s2[w])
+				return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief  Checks whether the row @p row is included in the row @p otherRow
+	 *         of @p other
+	 */
+	bool rowSubseteq(size_t row, const BitMatrix& other, size_t otherRow) const
+	{
+		assert(other.size_ == size_);
+		const Word* s1 = this->rowPtr(row);
+		const Word* s2 = other.rowPtr(otherRow);
+		for (size_t w = 0; w < rowWords_; ++w)
+		{
+			if (s1[w] & ~s2[w])
+				return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief  Returns the first column not lower than @p col that is set in the
+	 *         row @p row, or size() if there is none
+	 */
+	size_t nextInRow(size_t row, size_t col) const
+	{
+		if (col >= size_)
+			return size_;
+
+		const Word* s = this->rowPtr(row);
+		size_t w = col / WORD_BITS;
+		Word word = s[w] & (~static_cast<Word>(0) << (col % WORD_BITS));
+		while (!word)
+		{
+			if (++w == rowWords_)
+				return size_;
+
+			word = s[w];
+		}
+
+		return w * WORD_BITS + __builtin_ctzl(word);
+	}
+
+	/**
+	 * @brief  Element-wise intersection with a matrix of the same size
+	 */
+	BitMatrix& operator&=(const BitMatrix& rhs)
+	{
+		assert(rhs.size_ == size_);
+		for (size_t w = 0; w < data_.size(); ++w)
+			data_[w] &= rhs.data_[w];
+
+		return *this;
+	}
+
+	/**
+	 * @brief  Stores the transposition of the matrix into @p dst
+	 */
+	void transpose(BitMatrix& dst) const
+	{
+		assert(&dst != this);
+		dst.assign(size_, false);
+		for (size_t i = 0; i < size_; ++i)
+		{
+			for (size_t j = this->nextInRow(i, 0); j < size_; j = this->nextInRow(i, j + 1))
+				dst[j][i] = true;
+		}
+	}
+};
+
+#endif
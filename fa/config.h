@@ -65,5 +65,31 @@
  */
 #define FA_USE_PREDICATE_ABSTRACTION     0
 
+/**
+ * minimise a fixpoint only after this count of inclusion misses, the languages
+ * added in between are kept in a pending part (default is 1, i.e. minimise
+ * after each miss)
+ */
+#define FA_FIXPOINT_MINIMIZE_MISSES      1
+
+/**
+ * minimise a fixpoint also once its pending part has more than this count of
+ * transitions (default is 0, i.e. no limit)
+ */
+#define FA_FIXPOINT_PENDING_TRANS        0
+
+/**
+ * the maximal count of automata whose results of inclusion checks are cached,
+ * the cache is flushed once it grows bigger (default is 4096, 0 disables the
+ * cache)
+ */
+#define FA_INCLUSION_CACHE_SIZE          4096
+
+/**
+ * the count of queued states per worker process that is needed before the
+ * exploration is split among worker processes (default is 4)
+ */
+#define FA_WORKER_STATES_PER_JOB         4
+
 
 #endif /* CONFIG_H */
@@ -21,13 +21,15 @@
 #define EXECUTION_MANAGER_H
 
 // Standard library headers
-#include <list>
+#include <memory>
+#include <vector>
 
 // Forester headers
 #include "types.hh"
 #include "recycler.hh"
 #include "abstractinstruction.hh"
 #include "fixpointinstruction.hh"
+#include "searchstrategy.hh"
 #include "symstate.hh"
 
 
@@ -38,17 +40,16 @@
  */
 class ExecutionManager
 {
-private:  // data types
-
-	typedef std::list<SymState*> QueueType;
-
 private:  // data members
 
 	/// the root of the execution graph
 	SymState* root_;
 
 	/// the queue with the states to be processed
-	QueueType queue_;
+	std::unique_ptr<SearchStrategy> queue_;
+
+	/// the maximum count of states queued at once
+	size_t maxQueueSize_;
 
 	/// counter of evaluated states
 	size_t statesExecuted_;
@@ -86,9 +87,16 @@ private:  // methods
 
 public:
 
-	ExecutionManager() :
+	/**
+	 * @brief  The constructor
+	 *
+	 * @param[in]  strategy  The order of processing the queued states, the
+	 *                       manager takes its ownership (DFS if @p nullptr)
+	 */
+	explicit ExecutionManager(SearchStrategy* strategy = nullptr) :
 		root_(nullptr),
-		queue_{},
+		queue_((nullptr != strategy)?(strategy):(SearchStrategy::create("dfs"))),
+		maxQueueSize_{},
 		statesExecuted_{},
 		pathsEvaluated_{},
 		registerRecycler_{},
@@ -104,6 +112,35 @@ public:
 
 	size_t pathsEvaluated() const { return pathsEvaluated_; }
 
+	/**
+	 * @brief  Accounts for states and paths evaluated elsewhere
+	 *
+	 * This is used to add up the work done by worker processes.
+	 */
+	void addEvaluated(size_t states, size_t paths)
+	{
+		statesExecuted_ += states;
+		pathsEvaluated_ += paths;
+	}
+
+	size_t queueSize() const { return queue_->size(); }
+
+	/**
+	 * @brief  Accounts for states queued elsewhere at once
+	 */
+	void addQueueSize(size_t size)
+	{
+		if (maxQueueSize_ < size)
+			maxQueueSize_ = size;
+	}
+
+	/**
+	 * @brief  The maximum count of states queued at once since the last clear()
+	 */
+	size_t maxQueueSize() const { return maxQueueSize_; }
+
+	const char* strategyName() const { return queue_->name(); }
+
 	void clear()
 	{
 		if (nullptr != root_)
@@ -112,7 +149,8 @@ public:
 			root_ = nullptr;
 		}
 
-		queue_.clear();
+		queue_->clear();
+		maxQueueSize_ = 0;
 
 		statesExecuted_ = 0;
 		pathsEvaluated_ = 0;
@@ -186,9 +224,8 @@ public:
 		SymState* state = createState();
 
 		state->init(parent, instr, fae, registers);
-		queue_.push_back(state);
 
-		return state;
+		return this->enqueue(state);
 	}
 
 	SymState* enqueue(
@@ -197,34 +234,38 @@ public:
 		// Assertions
 		assert(nullptr != state);
 
-		queue_.push_back(state);
+		queue_->push(state);
+		if (maxQueueSize_ < queue_->size())
+			maxQueueSize_ = queue_->size();
+
 		return state;
 	}
 
-	SymState* dequeueBFS()
+	/**
+	 * @brief  Removes the next state to be processed from the queue
+	 *
+	 * @returns  The state chosen by the search strategy, or @p nullptr if the
+	 *           queue is empty
+	 */
+	SymState* dequeue()
 	{
-		if (queue_.empty())
-			return nullptr;
-
-		SymState* state = queue_.front();
-		assert(nullptr != state);
-
-		queue_.pop_front();
-
-		return state;
+		return queue_->pop();
 	}
 
-	SymState* dequeueDFS()
+	/**
+	 * @brief  Moves all queued states into @p states
+	 *
+	 * The states are stored in the order in which dequeue() would return them.
+	 *
+	 * @param[out]  states  The vector to receive the states
+	 */
+	void takeQueue(std::vector<SymState*>& states)
 	{
-		if (queue_.empty())
-			return nullptr;
-
-		SymState* state = queue_.back();
-		assert(nullptr != state);
+		states.clear();
 
-		queue_.pop_back();
-
-		return state;
+		SymState* state = nullptr;
+		while (nullptr != (state = queue_->pop()))
+			states.push_back(state);
 	}
 
 	std::shared_ptr<DataArray> allocRegisters(const DataArray& model)
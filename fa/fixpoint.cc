@@ -18,6 +18,7 @@
  */
 
 // Standard library headers
+#include <chrono>
 #include <ostream>
 
 // Code Listener headers
@@ -286,32 +287,6 @@ void reorder(
 	FA_DEBUG_AT(3, "after reordering: " << std::endl << fae);
 }
 
-bool testInclusion(
-	FAE&                           fae,
-	TreeAut&                       fwdConf,
-	UFAE&                          fwdConfWrapper)
-{
-	TreeAut ta(*fwdConf.backend);
-
-	Index<size_t> index;
-
-	fae.unreachableFree();
-
-	fwdConfWrapper.fae2ta(ta, index, fae);
-
-	if (TreeAut::subseteq(ta, fwdConf))
-		return true;
-
-	fwdConfWrapper.join(ta, index);
-
-	ta.clear();
-
-	fwdConf.minimized(ta);
-	fwdConf = ta;
-
-	return false;
-}
-
 struct CopyNonZeroRhsF
 {
 	bool operator()(const TT<label_type>* transition) const
@@ -392,6 +367,72 @@ void learn2(
 } // namespace
 
 
+bool FixpointBase::testInclusion(
+	FAE&                           fae)
+{
+	fae.unreachableFree();
+	fae.hashConsRoots();
+
+	ConfKey key = { fae.getRoots(), fae.GetVariables() };
+	if (joinedConfs_.count(key))
+	{	// the very same configuration has already been joined
+		return true;
+	}
+
+	TreeAut ta(*fwdConf_.backend);
+
+	Index<size_t> index;
+
+	fwdConfWrapper_.fae2ta(ta, index, fae);
+
+	if (!pendingConf_.getTransitions().empty()
+		&& TreeAut::subseteq(ta, pendingConf_))
+	{	// the pending part is small, so it is cheap to check it first
+		return true;
+	}
+
+	if (TreeAut::subseteq(ta, fwdConf_))
+		return true;
+
+	// both automata are going to change, the cached results are of no use
+	TreeAut::invalidateInclusion(pendingConf_);
+	TreeAut::invalidateInclusion(fwdConf_);
+
+	TreeAut::disjointUnion(pendingConf_, ta);
+	fwdConfWrapper_.join(ta, index);
+	joinedConfs_.insert(std::move(key));
+
+	++pendingMisses_;
+	if ((FA_FIXPOINT_MINIMIZE_MISSES <= pendingMisses_)
+		|| ((0 < FA_FIXPOINT_PENDING_TRANS)
+			&& (FA_FIXPOINT_PENDING_TRANS < pendingConf_.getTransitions().size())))
+	{
+		this->minimizeFixpoint();
+	}
+
+	return false;
+}
+
+void FixpointBase::minimizeFixpoint()
+{
+	const std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+
+	TreeAut::invalidateInclusion(pendingConf_);
+	TreeAut::invalidateInclusion(fwdConf_);
+
+	TreeAut ta(*fwdConf_.backend);
+	fwdConf_.minimized(ta);
+	fwdConf_ = ta;
+
+	pendingConf_.clear();
+	pendingMisses_ = 0;
+
+	++cntMinimizations_;
+	minimizationTime_ += std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
 SymState* FixpointBase::reverseAndIsect(
 	ExecutionManager&                      execMan,
 	const SymState&                        fwdPred,
@@ -532,7 +573,7 @@ void FI_abs::execute(ExecutionManager& execMan, SymState& state)
 	}
 #endif
 	// test inclusion
-	if (testInclusion(*fae, fwdConf_, fwdConfWrapper_))
+	if (this->testInclusion(*fae))
 	{
 		FA_DEBUG_AT(3, "hit");
 
@@ -598,7 +639,7 @@ void FI_fix::execute(ExecutionManager& execMan, SymState& state)
 	}
 #endif
 	// test inclusion
-	if (testInclusion(*fae, fwdConf_, fwdConfWrapper_))
+	if (this->testInclusion(*fae))
 	{
 		FA_DEBUG_AT(3, "hit");
 
@@ -23,6 +23,10 @@
 // Standard library headers
 #include <vector>
 #include <memory>
+#include <unordered_set>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
 
 // Forester headers
 #include "boxman.hh"
@@ -35,6 +39,33 @@
  */
 class FixpointBase : public FixpointInstruction
 {
+private:  // data types
+
+	/**
+	 * @brief  The data of an FAE that its encoding into @p fwdConf_ depends on
+	 *
+	 * Roots are compared by pointer, see FA::hashConsRoots().
+	 */
+	struct ConfKey
+	{
+		std::vector<std::shared_ptr<TreeAut>> roots;
+		DataArray variables;
+
+		bool operator==(const ConfKey& rhs) const
+		{
+			return (roots == rhs.roots) && (variables == rhs.variables);
+		}
+
+		friend size_t hash_value(const ConfKey& key)
+		{
+			size_t h = boost::hash_range(key.variables.begin(), key.variables.end());
+			for (const std::shared_ptr<TreeAut>& root : key.roots)
+				boost::hash_combine(h, root.get());
+
+			return h;
+		}
+	};
+
 protected:
 
 	/// Fixpoint configuration obtained in the forward run
@@ -42,12 +73,54 @@ protected:
 
 	UFAE fwdConfWrapper_;
 
+	/// Languages added to @p fwdConf_ since its last minimisation
+	TreeAut pendingConf_;
+
+	/// The number of inclusion misses since the last minimisation
+	size_t pendingMisses_;
+
+	/// The number of minimisations of @p fwdConf_
+	size_t cntMinimizations_;
+
+	/// The time spent minimising @p fwdConf_ (in seconds)
+	double minimizationTime_;
+
+	/// Configurations that have already been joined into @p fwdConf_
+	std::unordered_set<ConfKey, boost::hash<ConfKey>> joinedConfs_;
+
 	std::vector<std::shared_ptr<const FAE>> fixpoint_;
 
 	TreeAut::Backend& taBackend_;
 
 	BoxMan& boxMan_;
 
+protected:
+
+	/**
+	 * @brief  Tests whether a forest automaton is covered by the fixpoint
+	 *
+	 * This method tests whether the language of @p fae is included in the
+	 * fixpoint. If not, the language is added to the fixpoint. The pending part
+	 * of the fixpoint is checked first, since it is small. The fixpoint is
+	 * minimised once there have been @p FA_FIXPOINT_MINIMIZE_MISSES misses since
+	 * the last minimisation, or once the pending part grows over
+	 * @p FA_FIXPOINT_PENDING_TRANS transitions.
+	 * The roots of @p fae are hash-consed, so that configurations joined before
+	 * are recognised without any inclusion check.
+	 *
+	 * @param[in,out]  fae  The forest automaton to be tested
+	 *
+	 * @returns  @p true if the language of @p fae was already included in the
+	 *           fixpoint, @p false otherwise
+	 */
+	bool testInclusion(
+		FAE&                         fae);
+
+	/**
+	 * @brief  Minimises the fixpoint, including its pending part
+	 */
+	void minimizeFixpoint();
+
 public:
 
 	virtual void extendFixpoint(const std::shared_ptr<const FAE>& fae)
@@ -58,8 +131,13 @@ public:
 	virtual void clear()
 	{
 		fixpoint_.clear();
+		TreeAut::invalidateInclusion(fwdConf_);
+		TreeAut::invalidateInclusion(pendingConf_);
 		fwdConf_.clear();
 		fwdConfWrapper_.clear();
+		pendingConf_.clear();
+		pendingMisses_ = 0;
+		joinedConfs_.clear();
 	}
 
 #if 0
@@ -93,6 +171,11 @@ public:
 		FixpointInstruction(insn),
 		fwdConf_(fixpointBackend),
 		fwdConfWrapper_(fwdConf_, boxMan),
+		pendingConf_(fixpointBackend),
+		pendingMisses_(0),
+		cntMinimizations_(0),
+		minimizationTime_(0.0),
+		joinedConfs_{},
 		fixpoint_{},
 		taBackend_(taBackend),
 		boxMan_(boxMan)
@@ -106,6 +189,12 @@ public:
 		return fwdConf_;
 	}
 
+	virtual void getMinimizationStats(size_t& count, double& seconds) const
+	{
+		count = cntMinimizations_;
+		seconds = minimizationTime_;
+	}
+
 	virtual SymState* reverseAndIsect(
 		ExecutionManager&                      execMan,
 		const SymState&                        fwdPred,
@@ -39,6 +39,14 @@ public:
 
 	virtual const TreeAut& getFixPoint() const = 0;
 
+	/**
+	 * @brief  Retrieves statistics of minimisation of the fixpoint
+	 *
+	 * @param[out]  count    The number of minimisations performed so far
+	 * @param[out]  seconds  The time spent in the minimisations
+	 */
+	virtual void getMinimizationStats(size_t& count, double& seconds) const = 0;
+
 };
 
 #endif
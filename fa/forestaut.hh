@@ -200,6 +200,21 @@ public:   // methods
 		roots_.push_back(ta);
 	}
 
+	/**
+	 * @brief  Replaces the roots by their shared instances
+	 *
+	 * Roots that are structurally identical to roots of other FAs become
+	 * equal to them by pointer, see TreeAut::hashCons().
+	 */
+	void hashConsRoots()
+	{
+		for (std::shared_ptr<TreeAut>& root : roots_)
+		{
+			if (nullptr != root)
+				root = TreeAut::hashCons(root);
+		}
+	}
+
 	void resizeRoots(size_t newSize)
 	{
 		roots_.resize(newSize);
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUSION_CACHE_H
+#define INCLUSION_CACHE_H
+
+// Standard library headers
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Boost headers
+#include <boost/functional/hash.hpp>
+
+// Forester headers
+#include "antichainext.hh"
+#include "cache.hh"
+#include "config.h"
+#include "treeaut.hh"
+
+/**
+ * @brief  Cache of results of language inclusion checks of tree automata
+ *
+ * Automata are identified by their structural signature, i.e. the sorted list
+ * of their transitions and final states, so that two automata with the same
+ * signature accept the same language, no matter which backend they live in.
+ * Signatures are interned in a Cache, dropping a signature invalidates all
+ * results computed for it.
+ */
+template <class T>
+class InclusionCache
+{
+public:   // data types
+
+	/**
+	 * @brief  Structural signature of a tree automaton
+	 */
+	struct Signature
+	{
+		/// (label, rhs followed by lhs) for each transition, sorted
+		std::vector<std::pair<T, std::vector<size_t>>> transitions;
+
+		/// sorted final states
+		std::vector<size_t> finalStates;
+
+		explicit Signature(const TA<T>& ta) :
+			transitions{},
+			finalStates(ta.getFinalStates().begin(), ta.getFinalStates().end())
+		{
+			transitions.reserve(ta.getTransitions().size());
+			for (const typename TA<T>::TransIDPair* trans : ta.getTransitions())
+			{
+				std::vector<size_t> states(1, trans->first.rhs());
+				states.insert(states.end(),
+					trans->first.lhs().begin(), trans->first.lhs().end());
+				transitions.push_back(std::make_pair(trans->first.label(), states));
+			}
+
+			std::sort(transitions.begin(), transitions.end());
+		}
+
+		bool operator==(const Signature& rhs) const
+		{
+			return (finalStates == rhs.finalStates)
+				&& (transitions == rhs.transitions);
+		}
+
+		friend size_t hash_value(const Signature& sig)
+		{
+			size_t h = boost::hash_range(
+				sig.finalStates.begin(), sig.finalStates.end());
+			boost::hash_combine(h, sig.transitions);
+			return h;
+		}
+	};
+
+	typedef Cache<Signature> sig_cache_type;
+
+	typedef typename sig_cache_type::value_type* sig_type;
+
+private:  // data types
+
+	struct SubseteqF
+	{
+		const TA<T>& a;
+		const TA<T>& b;
+		bool& computed;
+
+		SubseteqF(const TA<T>& a, const TA<T>& b, bool& computed) :
+			a(a),
+			b(b),
+			computed(computed)
+		{ }
+
+		bool operator()(sig_type, sig_type) const
+		{
+			computed = true;
+			return AntichainExt<T>::subseteq(a, b);
+		}
+	};
+
+	struct SigCacheListener : public sig_cache_type::Listener
+	{
+		struct NoOp { void operator()(bool) {} };
+
+		InclusionCache& cache;
+
+		SigCacheListener(InclusionCache& cache) :
+			cache(cache)
+		{
+			this->cache.sigCache_.addListener(this);
+		}
+
+		virtual void drop(typename sig_cache_type::value_type* x)
+		{
+			this->cache.results_.invalidateKey(x, NoOp());
+		}
+	};
+
+private:  // data members
+
+	/// interned signatures of automata
+	sig_cache_type sigCache_;
+
+	/// results of inclusion checks of pairs of signatures
+	CachedBinaryOp<sig_type, bool> results_;
+
+	SigCacheListener listener_;
+
+	/// the number of signatures interned in @p sigCache_
+	size_t cntSigs_;
+
+	size_t cntHits_;
+	size_t cntMisses_;
+
+private:  // methods
+
+	InclusionCache(const InclusionCache&);
+	InclusionCache& operator=(const InclusionCache&);
+
+	sig_type intern(const TA<T>& ta)
+	{
+		Signature sig(ta);
+		sig_type x = sigCache_.find(sig);
+		if (nullptr != x)
+			return x;
+
+		++cntSigs_;
+		return sigCache_.lookup(sig);
+	}
+
+public:   // methods
+
+	InclusionCache() :
+		sigCache_{},
+		results_{},
+		listener_(*this),
+		cntSigs_(0),
+		cntHits_(0),
+		cntMisses_(0)
+	{ }
+
+	/**
+	 * @brief  Checks language inclusion of @p a in @p b
+	 *
+	 * The result is looked up in the cache first, the check is only performed
+	 * if it is not found there.
+	 */
+	bool subseteq(const TA<T>& a, const TA<T>& b)
+	{
+		if (!FA_INCLUSION_CACHE_SIZE)
+			return AntichainExt<T>::subseteq(a, b);
+
+		if (FA_INCLUSION_CACHE_SIZE < cntSigs_ + 2)
+		{	// the cache is full, start from scratch
+			sigCache_.clear();
+			cntSigs_ = 0;
+		}
+
+		sig_type x = this->intern(a);
+		sig_type y = this->intern(b);
+		if (x == y)
+		{	// the very same automaton
+			++cntHits_;
+			return true;
+		}
+
+		bool computed = false;
+		const bool result = results_.lookup(x, y, SubseteqF(a, b, computed));
+		if (computed)
+			++cntMisses_;
+		else
+			++cntHits_;
+
+		return result;
+	}
+
+	/**
+	 * @brief  Drops all results computed for the automaton @p ta
+	 *
+	 * This is to be called when an automaton that is often checked against is
+	 * going to change, so that the results for its old shape do not pile up.
+	 */
+	void invalidate(const TA<T>& ta)
+	{
+		sig_type x = sigCache_.find(Signature(ta));
+		if (nullptr == x)
+			return;
+
+		--cntSigs_;
+		sigCache_.release(x);
+	}
+
+	size_t hits() const
+	{
+		return cntHits_;
+	}
+
+	size_t misses() const
+	{
+		return cntMisses_;
+	}
+};
+
+#endif
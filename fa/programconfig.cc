@@ -17,8 +17,13 @@
  * along with forester.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+// Standard library headers
+#include <cstdlib>
+#include <memory>
+
 // Forester headers
 #include "programconfig.hh"
+#include "searchstrategy.hh"
 
 void ProgramConfig::processArg(const std::string& arg)
 {
@@ -84,5 +89,35 @@ void ProgramConfig::processArg(const std::string& arg)
 		return;
 	}
 
+	if (std::string("jobs") == key)
+	{
+		char* end = nullptr;
+		const unsigned long jobs = (data.size() == 2)?
+			(std::strtoul(data[1].c_str(), &end, 10)):(0);
+
+		if (!jobs || (nullptr == end) || ('\0' != *end))
+		{
+			throw std::invalid_argument("use \"jobs:<count>\"");
+		}
+
+		this->jobs = jobs;
+		FA_LOG("Config::processArg: \"jobs\" is " << this->jobs);
+		return;
+	}
+
+	if (std::string("search") == key)
+	{
+		if ((data.size() != 2)
+			|| !std::unique_ptr<SearchStrategy>(SearchStrategy::create(data[1])))
+		{
+			throw std::invalid_argument(
+				"use \"search:<dfs|bfs|loop-depth|fixpoint-first>\"");
+		}
+
+		this->searchStrategy = data[1];
+		FA_LOG("Config::processArg: \"search\" is \"" + this->searchStrategy + "\"");
+		return;
+	}
+
 	FA_WARN("unhandled argument: \"" << arg << "\"");
 }
@@ -20,6 +20,10 @@
 #ifndef _PROGRAMCONFIG_HH_
 #define _PROGRAMCONFIG_HH_
 
+// Standard library headers
+#include <string>
+#include <vector>
+
 // Boost headers
 #include <boost/algorithm/string.hpp>
 
@@ -36,6 +40,8 @@ public:   // data members
 	bool        onlyCompile;        ///< only compiling?
 	bool        printTrace;         ///< printing trace for errors?
 	bool        printUcodeTrace;    ///< printing microcode trace for errors?
+	size_t      jobs;               ///< number of worker processes
+	std::string searchStrategy;     ///< order of processing of queued states
 
 private:  // methods
 
@@ -49,7 +55,9 @@ public:   // methods
 		printOrigCode(false),
 		onlyCompile(false),
 		printTrace(false),
-		printUcodeTrace(false)
+		printUcodeTrace(false),
+		jobs(1),
+		searchStrategy("dfs")
 	{
 		std::vector<std::string> args;
 		boost::split(args, confStr, boost::is_any_of(";"));
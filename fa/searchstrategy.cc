@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of forester.
+ *
+ * forester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * forester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with forester.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Standard library headers
+#include <list>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Code Listener headers
+#include <cl/storage.hh>
+
+// Forester headers
+#include "abstractinstruction.hh"
+#include "searchstrategy.hh"
+#include "symstate.hh"
+
+namespace
+{
+	class DFSStrategy : public SearchStrategy
+	{
+	private:  // data members
+
+		std::list<SymState*> queue_;
+
+	public:   // methods
+
+		DFSStrategy() :
+			queue_{}
+		{ }
+
+		virtual const char* name() const
+		{
+			return "dfs";
+		}
+
+		virtual void push(SymState* state)
+		{
+			queue_.push_back(state);
+		}
+
+		virtual SymState* pop()
+		{
+			if (queue_.empty())
+				return nullptr;
+
+			SymState* state = queue_.back();
+			queue_.pop_back();
+
+			return state;
+		}
+
+		virtual size_t size() const
+		{
+			return queue_.size();
+		}
+
+		virtual void clear()
+		{
+			queue_.clear();
+		}
+	};
+
+	class BFSStrategy : public SearchStrategy
+	{
+	private:  // data members
+
+		std::list<SymState*> queue_;
+
+	public:   // methods
+
+		BFSStrategy() :
+			queue_{}
+		{ }
+
+		virtual const char* name() const
+		{
+			return "bfs";
+		}
+
+		virtual void push(SymState* state)
+		{
+			queue_.push_back(state);
+		}
+
+		virtual SymState* pop()
+		{
+			if (queue_.empty())
+				return nullptr;
+
+			SymState* state = queue_.front();
+			queue_.pop_front();
+
+			return state;
+		}
+
+		virtual size_t size() const
+		{
+			return queue_.size();
+		}
+
+		virtual void clear()
+		{
+			queue_.clear();
+		}
+	};
+
+	/**
+	 * @brief  Prefers states at more deeply nested loops
+	 *
+	 * The loop nesting depth of a basic block is the count of natural loops
+	 * containing it. The loops are given by the loop-closing edges found by
+	 * Code Listener, the depths are computed once for each function.
+	 */
+	class LoopDepthStrategy : public SearchStrategy
+	{
+	private:  // data types
+
+		struct Item
+		{
+			size_t depth;
+			size_t order;
+			SymState* state;
+
+			bool operator<(const Item& rhs) const
+			{
+				return (depth < rhs.depth)
+					|| ((depth == rhs.depth) && (order < rhs.order));
+			}
+		};
+
+	private:  // data members
+
+		std::priority_queue<Item> queue_;
+
+		/// the count of states queued so far
+		size_t order_;
+
+		/// the functions the loops of which have been scanned
+		std::unordered_set<const CodeStorage::ControlFlow*> scanned_;
+
+		/// the loop nesting depths of basic blocks inside loops
+		std::unordered_map<const CodeStorage::Block*, size_t> depth_;
+
+	private:  // methods
+
+		void scan(const CodeStorage::ControlFlow& cfg)
+		{
+			// the bodies of the loops, by their headers
+			std::unordered_map<const CodeStorage::Block*,
+				std::unordered_set<const CodeStorage::Block*>> loops;
+
+			for (const CodeStorage::Block* bb : cfg)
+			{
+				const CodeStorage::Insn* term = bb->back();
+				for (unsigned idx : term->loopClosingTargets)
+				{	// collect the blocks reaching 'bb' without passing the header
+					const CodeStorage::Block* header = term->targets[idx];
+
+					std::unordered_set<const CodeStorage::Block*>& body = loops[header];
+					body.insert(header);
+
+					std::vector<const CodeStorage::Block*> todo;
+					if (body.insert(bb).second)
+						todo.push_back(bb);
+
+					while (!todo.empty())
+					{
+						const CodeStorage::Block* block = todo.back();
+						todo.pop_back();
+
+						for (const CodeStorage::Block* pred : block->inbound())
+						{
+							if (body.insert(pred).second)
+								todo.push_back(pred);
+						}
+					}
+				}
+			}
+
+			for (const auto& loop : loops)
+			{
+				for (const CodeStorage::Block* block : loop.second)
+					++depth_[block];
+			}
+		}
+
+		size_t loopDepth(const SymState& state)
+		{
+			const CodeStorage::Insn* insn = state.GetInstr()->insn();
+			if ((nullptr == insn) || (nullptr == insn->bb))
+				return 0;
+
+			const CodeStorage::ControlFlow* cfg = insn->bb->cfg();
+			if (nullptr != cfg && scanned_.insert(cfg).second)
+				this->scan(*cfg);
+
+			auto i = depth_.find(insn->bb);
+			return (depth_.end() == i)?(0):(i->second);
+		}
+
+	public:   // methods
+
+		LoopDepthStrategy() :
+			queue_{},
+			order_(0),
+			scanned_{},
+			depth_{}
+		{ }
+
+		virtual const char* name() const
+		{
+			return "loop-depth";
+		}
+
+		virtual void push(SymState* state)
+		{
+			queue_.push(Item{this->loopDepth(*state), order_++, state});
+		}
+
+		virtual SymState* pop()
+		{
+			if (queue_.empty())
+				return nullptr;
+
+			SymState* state = queue_.top().state;
+			queue_.pop();
+
+			return state;
+		}
+
+		virtual size_t size() const
+		{
+			return queue_.size();
+		}
+
+		virtual void clear()
+		{
+			queue_ = std::priority_queue<Item>();
+		}
+	};
+
+	/**
+	 * @brief  Prefers states about to execute a fixpoint instruction
+	 *
+	 * Running abstraction and the inclusion check early lets the fixpoints
+	 * cut the other states sooner.
+	 */
+	class FixpointFirstStrategy : public SearchStrategy
+	{
+	private:  // data members
+
+		std::list<SymState*> fixpoints_;
+
+		std::list<SymState*> others_;
+
+	public:   // methods
+
+		FixpointFirstStrategy() :
+			fixpoints_{},
+			others_{}
+		{ }
+
+		virtual const char* name() const
+		{
+			return "fixpoint-first";
+		}
+
+		virtual void push(SymState* state)
+		{
+			if (state->GetInstr()->getType() == fi_type_e::fiFix)
+				fixpoints_.push_back(state);
+			else
+				others_.push_back(state);
+		}
+
+		virtual SymState* pop()
+		{
+			std::list<SymState*>& queue = (fixpoints_.empty())?(others_):(fixpoints_);
+			if (queue.empty())
+				return nullptr;
+
+			SymState* state = queue.back();
+			queue.pop_back();
+
+			return state;
+		}
+
+		virtual size_t size() const
+		{
+			return fixpoints_.size() + others_.size();
+		}
+
+		virtual void clear()
+		{
+			fixpoints_.clear();
+			others_.clear();
+		}
+	};
+} // namespace
+
+
+SearchStrategy* SearchStrategy::create(const std::string& name)
+{
+	if ("dfs" == name)
+		return new DFSStrategy();
+
+	if ("bfs" == name)
+		return new BFSStrategy();
+
+	if ("loop-depth" == name)
+		return new LoopDepthStrategy();
+
+	if ("fixpoint-first" == name)
+		return new FixpointFirstStrategy();
+
+	return nullptr;
+}
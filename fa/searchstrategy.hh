@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of forester.
+ *
+ * forester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * forester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with forester.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCH_STRATEGY_H
+#define SEARCH_STRATEGY_H
+
+// Standard library headers
+#include <cstddef>
+#include <string>
+
+class SymState;
+
+/**
+ * @brief  The order in which pending states of the symbolic execution are
+ *         processed
+ *
+ * The strategies are:
+ *   - @e dfs             the most recently queued state first (the default),
+ *   - @e bfs             the least recently queued state first,
+ *   - @e loop-depth      the state at the most deeply nested loop first,
+ *   - @e fixpoint-first  states about to execute a fixpoint instruction first.
+ *
+ * States of equal priority are processed in the DFS order.
+ */
+class SearchStrategy
+{
+private:  // methods
+
+	SearchStrategy(const SearchStrategy&);
+	SearchStrategy& operator=(const SearchStrategy&);
+
+protected:
+
+	SearchStrategy()
+	{ }
+
+public:   // methods
+
+	virtual ~SearchStrategy()
+	{ }
+
+	/**
+	 * @brief  Creates a strategy of the given name
+	 *
+	 * @param[in]  name  The name of the strategy
+	 *
+	 * @returns  The new strategy, or @p nullptr if there is no strategy of the
+	 *           name @p name
+	 */
+	static SearchStrategy* create(const std::string& name);
+
+	/**
+	 * @brief  The name of the strategy, as accepted by create()
+	 */
+	virtual const char* name() const = 0;
+
+	virtual void push(SymState* state) = 0;
+
+	/**
+	 * @brief  Removes the next state to be processed
+	 *
+	 * @returns  The state, or @p nullptr if there is no pending state
+	 */
+	virtual SymState* pop() = 0;
+
+	virtual size_t size() const = 0;
+
+	virtual void clear() = 0;
+};
+
+#endif
@@ -41,6 +41,18 @@ void reportErrorNoLocation(const char* errMsg)
 #include <list>
 #include <set>
 #include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 // Code Listener headers
 #include <cl/cl_msg.hh>
@@ -60,6 +72,7 @@ void reportErrorNoLocation(const char* errMsg)
 #include "programconfig.hh"
 #include "programerror.hh"
 #include "restart_request.hh"
+#include "searchstrategy.hh"
 #include "symctx.hh"
 #include "symexec.hh"
 
@@ -183,11 +196,181 @@ std::ostream& printUcodeTrace(
 
 	return os;
 }
+
+
+/// file descriptor the current worker process records its messages to
+int workerMsgFd = -1;
+
+/**
+ * @brief  Writes the whole buffer to the message file of the worker
+ *
+ * @param[in]  buf  The buffer
+ * @param[in]  len  The length of the buffer
+ */
+void writeAll(const void* buf, size_t len)
+{
+	const char* ptr = static_cast<const char*>(buf);
+	while (len)
+	{
+		const ssize_t rv = write(workerMsgFd, ptr, len);
+		if (rv < 0)
+		{
+			if (EINTR == errno)
+				continue;
+
+			// the parent process explores the sub-tree again
+			_exit(EXIT_FAILURE);
+		}
+
+		ptr += rv;
+		len -= rv;
+	}
+}
+
+/**
+ * @brief  Records a message of the worker for the parent process
+ *
+ * @param[in]  kind  The kind of the message (see replayMsgs())
+ * @param[in]  msg   The message
+ * @param[in]  len   The length of the message
+ */
+void recordMsg(char kind, const char* msg, size_t len)
+{
+	const uint32_t len32 = len;
+	writeAll(&kind, sizeof(kind));
+	writeAll(&len32, sizeof(len32));
+	writeAll(msg, len);
+}
+
+void recordDebug(const char* msg) { recordMsg('D', msg, strlen(msg)); }
+void recordWarn (const char* msg) { recordMsg('W', msg, strlen(msg)); }
+void recordError(const char* msg) { recordMsg('E', msg, strlen(msg)); }
+void recordNote (const char* msg) { recordMsg('N', msg, strlen(msg)); }
+
+void recordDie(const char*)
+{	// the parent process explores the sub-tree again and dies on its own
+	_exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief  Stream buffer recording the output of a standard stream
+ *
+ * The debugging output goes directly to @p std::cerr, @p std::clog and
+ * @p std::cout rather than through the code listener, so the workers record
+ * it as well.
+ */
+class RecordBuf : public std::streambuf
+{
+private:  // data members
+
+	/// the kind of the records (see replayMsgs())
+	const char kind_;
+
+	/// the output not recorded yet
+	std::string text_;
+
+public:   // methods
+
+	explicit RecordBuf(char kind) :
+		kind_(kind),
+		text_{}
+	{ }
+
+	~RecordBuf()
+	{
+		this->sync();
+	}
+
+protected:// methods
+
+	virtual int overflow(int c) override
+	{
+		if (traits_type::eq_int_type(traits_type::eof(), c))
+			return traits_type::not_eof(c);
+
+		text_.push_back(traits_type::to_char_type(c));
+		if ('\n' == c)
+			this->sync();
+
+		return c;
+	}
+
+	virtual int sync() override
+	{
+		if (!text_.empty())
+		{
+			recordMsg(kind_, text_.data(), text_.size());
+			text_.clear();
+		}
+
+		return 0;
+	}
+};
+
+/**
+ * @brief  Replays the messages recorded by a worker in the parent process
+ *
+ * @param[in]  fp  The file the worker has recorded its messages to
+ */
+void replayMsgs(FILE* fp)
+{
+	rewind(fp);
+
+	char kind;
+	uint32_t len;
+	while ((1 == fread(&kind, sizeof(kind), 1, fp))
+		&& (1 == fread(&len, sizeof(len), 1, fp)))
+	{
+		std::string msg(len, '\0');
+		if (len && (1 != fread(&msg[0], len, 1, fp)))
+			break;
+
+		switch (kind)
+		{
+			case 'D': cl_debug(msg.c_str()); break;
+			case 'W': cl_warn (msg.c_str()); break;
+			case 'E': cl_error(msg.c_str()); break;
+			case 'N': cl_note (msg.c_str()); break;
+			case 'O': std::cout << msg;      break;
+			case 'R': std::cerr << msg;      break;
+
+			default:
+				assert(false);
+				return;
+		}
+	}
+}
 } // namespace
 
 
 class SymExec::Engine
 {
+private:  // data types
+
+	/**
+	 * @brief  Statistics passed from a worker process to its parent
+	 */
+	struct WorkerStats
+	{
+		size_t statesEvaluated;
+		size_t pathsEvaluated;
+		size_t maxQueueSize;
+		size_t cntMinimizations;
+		double minimizationTime;
+		size_t cntInclusionHits;
+		size_t cntInclusionMisses;
+	};
+
+	/**
+	 * @brief  A state of the frontier handed over to a worker process
+	 */
+	struct WorkerJob
+	{
+		SymState* state;  ///< the state to start from
+		FILE*     msgs;   ///< the messages recorded by the worker
+		bool      done;   ///< the worker has explored the whole sub-tree
+	};
+
 private:  // data members
 
 	TreeAut::Backend taBackend_;
@@ -204,6 +387,12 @@ private:  // data members
 	volatile bool dbgFlag_;
 	volatile bool userRequestFlag_;
 
+	/// is the exploration to be split among worker processes?
+	const bool useWorkers_;
+
+	/// the statistics of fixpoints and inclusion checks from worker processes
+	WorkerStats workerStats_;
+
 protected:
 
 	/**
@@ -252,6 +441,303 @@ protected:
 	}
 
 
+	/**
+	 * @brief  Processes the queued states in the order of the search strategy
+	 *
+	 * @param[in]  frontier  If nonzero, processing stops once this count of
+	 *                       states is queued
+	 *
+	 * @returns  @p true if the queue has been emptied, @p false if it has grown
+	 *           to @p frontier states
+	 */
+	bool processQueue(size_t frontier)
+	{
+		SymState* state = nullptr;
+
+		while (nullptr != (state = execMan_.dequeue()))
+		{	// process all states in the order of the search strategy
+			assert(nullptr != state);
+
+			const CodeStorage::Insn* insn = state->GetInstr()->insn();
+			if (nullptr != insn)
+			{	// in case current instruction IS an instruction
+				FA_DEBUG_AT(2, SSD_INLINE_COLOR(C_LIGHT_RED, insn->loc << *insn));
+				FA_DEBUG_AT(2, *state);
+			}
+			else
+			{
+				FA_DEBUG_AT(3, *state);
+			}
+
+			if (testAndClearUserRequestFlag())
+			{
+				FA_NOTE("Executed " << std::setw(7) << execMan_.statesEvaluated()
+					<< " states and " << std::setw(7) << execMan_.pathsEvaluated()
+					<< " paths so far.");
+			}
+
+			// run the state
+			execMan_.execute(*state);
+
+			if (frontier && (frontier <= execMan_.queueSize()))
+				return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief  Collects the statistics of this process
+	 *
+	 * @param[out]  stats  The statistics
+	 */
+	void getStats(WorkerStats& stats) const
+	{
+		stats.statesEvaluated = execMan_.statesEvaluated();
+		stats.pathsEvaluated = execMan_.pathsEvaluated();
+		stats.maxQueueSize = execMan_.maxQueueSize();
+		stats.cntMinimizations = 0;
+		stats.minimizationTime = 0.0;
+
+		for (auto instr : assembly_.code_)
+		{
+			if (instr->getType() != fi_type_e::fiFix)
+				continue;
+
+			size_t cnt;
+			double seconds;
+			static_cast<FixpointInstruction*>(instr)->getMinimizationStats(
+				cnt, seconds);
+			stats.cntMinimizations += cnt;
+			stats.minimizationTime += seconds;
+		}
+
+		TreeAut::getInclusionStats(
+			stats.cntInclusionHits, stats.cntInclusionMisses);
+	}
+
+	/**
+	 * @brief  Explores the sub-tree of @p state in a worker process
+	 *
+	 * This method is called in a freshly forked worker process and never
+	 * returns.  The worker exits with zero status iff it has explored the whole
+	 * sub-tree without reaching an error, a restart request or a new box, in
+	 * which case the statistics of its own work are written to @p fd.  All
+	 * messages of the worker are recorded to @p job.msgs, the parent process
+	 * replays them in the order of the frontier.
+	 *
+	 * @param[in]  job  The job of the worker
+	 * @param[in]  fd   The write end of the pipe to the parent process
+	 */
+	void runWorker(const WorkerJob& job, int fd)
+	{
+		// the output of workers would interleave in a non-deterministic way
+		workerMsgFd = fileno(job.msgs);
+		struct cl_init_data init;
+		init.debug       = recordDebug;
+		init.warn        = recordWarn;
+		init.error       = recordError;
+		init.note        = recordNote;
+		init.die         = recordDie;
+		init.debug_level = cl_debug_level();
+		cl_global_init(&init);
+
+		RecordBuf outBuf('O');
+		RecordBuf errBuf('R');
+		std::cout.rdbuf(&outBuf);
+		std::cerr.rdbuf(&errBuf);
+		std::clog.rdbuf(&errBuf);
+
+		SymState* state = job.state;
+		int status = 1;
+		try
+		{
+			const size_t cntBoxes = boxMan_.boxDatabase().size();
+
+			WorkerStats before;
+			this->getStats(before);
+
+			execMan_.enqueue(state);
+
+			// the boxes learnt here would be lost for the parent process
+			if (this->processQueue(0)
+				&& (cntBoxes == boxMan_.boxDatabase().size()))
+			{
+				WorkerStats stats;
+				this->getStats(stats);
+				stats.statesEvaluated    -= before.statesEvaluated;
+				stats.pathsEvaluated     -= before.pathsEvaluated;
+				stats.cntMinimizations   -= before.cntMinimizations;
+				stats.minimizationTime   -= before.minimizationTime;
+				stats.cntInclusionHits   -= before.cntInclusionHits;
+				stats.cntInclusionMisses -= before.cntInclusionMisses;
+
+				if (sizeof(stats) == write(fd, &stats, sizeof(stats)))
+					status = 0;
+			}
+		}
+		catch (...)
+		{	// the sub-tree is left to the parent process
+		}
+
+		std::cout.flush();
+		std::cerr.flush();
+		_exit(status);
+	}
+
+	/**
+	 * @brief  Explores the queued states using worker processes
+	 *
+	 * Each queued state is explored in its own forked worker process, at most
+	 * @p conf_.jobs of them run at a time.  The workers start from the state of
+	 * the fixpoints at the time of the split, so that the result does not
+	 * depend on the order in which they are scheduled.
+	 *
+	 * @param[out]  jobs  The jobs in the order of the search strategy, the
+	 *                    caller is responsible for closing their @p msgs
+	 */
+	void exploreInWorkers(std::vector<WorkerJob>& jobs)
+	{
+		std::vector<SymState*> frontier;
+		execMan_.takeQueue(frontier);
+
+		for (SymState* state : frontier)
+			jobs.push_back(WorkerJob{state, tmpfile(), false});
+
+		FA_DEBUG_AT(1, "exploring " << jobs.size() << " state(s) using "
+			<< conf_.jobs << " worker process(es) ...");
+
+		// do not let the workers inherit buffered output
+		std::cout.flush();
+		std::cerr.flush();
+		fflush(nullptr);
+
+		// pid of the worker -> (read end of its pipe, index of its job)
+		std::map<pid_t, std::pair<int, size_t>> running;
+		size_t next = 0;
+
+		while ((next < jobs.size()) || !running.empty())
+		{
+			if ((next < jobs.size()) && (running.size() < conf_.jobs))
+			{	// start a new worker
+				int fds[2];
+				if ((nullptr == jobs[next].msgs) || pipe(fds))
+				{	// leave the state to the parent process
+					++next;
+					continue;
+				}
+
+				const pid_t pid = fork();
+				if (-1 == pid)
+				{
+					close(fds[0]);
+					close(fds[1]);
+					++next;
+					continue;
+				}
+
+				if (0 == pid)
+				{
+					close(fds[0]);
+					this->runWorker(jobs[next], fds[1]);
+				}
+
+				close(fds[1]);
+				running.insert(std::make_pair(pid, std::make_pair(fds[0], next)));
+				++next;
+				continue;
+			}
+
+			// wait for a worker to finish
+			int status;
+			const pid_t pid = waitpid(-1, &status, 0);
+			if (-1 == pid)
+			{
+				if (EINTR == errno)
+					continue;
+
+				break;
+			}
+
+			const auto i = running.find(pid);
+			if (running.end() == i)
+				continue;
+
+			WorkerStats stats;
+			const int fd = i->second.first;
+			const size_t idx = i->second.second;
+			jobs[idx].done = WIFEXITED(status) && (0 == WEXITSTATUS(status))
+				&& (sizeof(stats) == read(fd, &stats, sizeof(stats)));
+
+			close(fd);
+			running.erase(i);
+
+			if (!jobs[idx].done)
+				continue;
+
+			execMan_.addEvaluated(stats.statesEvaluated, stats.pathsEvaluated);
+			execMan_.addQueueSize(stats.maxQueueSize);
+			workerStats_.cntMinimizations   += stats.cntMinimizations;
+			workerStats_.minimizationTime   += stats.minimizationTime;
+			workerStats_.cntInclusionHits   += stats.cntInclusionHits;
+			workerStats_.cntInclusionMisses += stats.cntInclusionMisses;
+		}
+
+		for (const auto& worker : running)
+		{	// waitpid() failed, do not leave zombies behind
+			kill(worker.first, SIGKILL);
+			waitpid(worker.first, nullptr, 0);
+			close(worker.second.first);
+		}
+	}
+
+	/**
+	 * @brief  Finishes the jobs of the worker processes in their order
+	 *
+	 * The messages of each completed job are replayed, the state of each
+	 * failed job is explored in-process, so that the output is the same as if
+	 * the jobs were explored one by one in the parent process.
+	 *
+	 * @param[in]  jobs  The jobs from exploreInWorkers()
+	 */
+	void finishJobs(std::vector<WorkerJob>& jobs)
+	{
+		size_t i = 0;
+		try
+		{
+			for (; i < jobs.size(); ++i)
+			{
+				WorkerJob& job = jobs[i];
+				if (job.done)
+				{
+					replayMsgs(job.msgs);
+				}
+				else
+				{	// errors and restart requests are handled the usual way
+					FA_DEBUG_AT(1, "a worker process failed, exploring its "
+						"state in-process ...");
+
+					execMan_.enqueue(job.state);
+					this->processQueue(0);
+				}
+
+				if (nullptr != job.msgs)
+					fclose(job.msgs);
+			}
+		}
+		catch (...)
+		{	// the rest would not be reached by the serial analysis either
+			for (; i < jobs.size(); ++i)
+			{
+				if (nullptr != jobs[i].msgs)
+					fclose(jobs[i].msgs);
+			}
+
+			throw;
+		}
+	}
+
+
 	/**
 	 * @brief  The main execution loop
 	 *
@@ -309,35 +795,18 @@ protected:
 			assembly_.code_.front()
 		);
 
-		SymState* state = nullptr;
-
 		try
 		{	// expecting problems...
-			while (nullptr != (state = execMan_.dequeueDFS()))
-			{	// process all states in the DFS order
-				assert(nullptr != state);
-
-				const CodeStorage::Insn* insn = state->GetInstr()->insn();
-				if (nullptr != insn)
-				{	// in case current instruction IS an instruction
-					FA_DEBUG_AT(2, SSD_INLINE_COLOR(C_LIGHT_RED, insn->loc << *insn));
-					FA_DEBUG_AT(2, *state);
-				}
-				else
-				{
-					FA_DEBUG_AT(3, *state);
-				}
+			const size_t frontier = (useWorkers_)?
+				(conf_.jobs * FA_WORKER_STATES_PER_JOB):(0);
 
-				if (testAndClearUserRequestFlag())
-				{
-					FA_NOTE("Executed " << std::setw(7) << execMan_.statesEvaluated()
-						<< " states and " << std::setw(7) << execMan_.pathsEvaluated()
-						<< " paths so far.");
-				}
+			if (this->processQueue(frontier))
+				return true;
 
-				// run the state
-				execMan_.execute(*state);
-			}
+			// the queue is big enough to be split among worker processes
+			std::vector<WorkerJob> jobs;
+			this->exploreInWorkers(jobs);
+			this->finishJobs(jobs);
 
 			return true;
 		}
@@ -449,10 +918,12 @@ public:   // methods
 		boxMan_{},
 		compiler_(fixpointBackend_, taBackend_, boxMan_),
 		assembly_{},
-		execMan_{},
+		execMan_(SearchStrategy::create(conf.searchStrategy)),
 		conf_(conf),
 		dbgFlag_{false},
-		userRequestFlag_{false}
+		userRequestFlag_{false},
+		useWorkers_(1 < conf.jobs),
+		workerStats_{}
 	{ }
 
 	/**
@@ -593,6 +1064,8 @@ public:   // methods
 			// print out boxes
 			this->printBoxes();
 
+			size_t cntMinimizations = 0;
+			double minimizationTime = 0.0;
 			for (auto instr : assembly_.code_)
 			{	// print out all fixpoints
 				if (instr->getType() != fi_type_e::fiFix)
@@ -600,6 +1073,13 @@ public:   // methods
 					continue;
 				}
 
+				size_t cnt;
+				double seconds;
+				static_cast<FixpointInstruction*>(instr)->getMinimizationStats(
+					cnt, seconds);
+				cntMinimizations += cnt;
+				minimizationTime += seconds;
+
 				if (instr->insn())
 				{
 					FA_DEBUG_AT(1, "fixpoint at " << instr->insn()->loc << std::endl
@@ -611,10 +1091,26 @@ public:   // methods
 				}
 			}
 
+			// the fixpoints of worker processes are lost, their statistics not
+			cntMinimizations += workerStats_.cntMinimizations;
+			minimizationTime += workerStats_.minimizationTime;
+
 			// print out stats
 			FA_DEBUG_AT(1, "forester has generated " << execMan_.statesEvaluated()
 				<< " symbolic configuration(s) in " << execMan_.pathsEvaluated()
 				<< " path(s) using " << boxMan_.boxDatabase().size() << " box(es)");
+			FA_DEBUG_AT(1, "fixpoints have been minimised " << cntMinimizations
+				<< " time(s), which took " << minimizationTime << " s");
+
+			size_t cntHits = 0, cntMisses = 0;
+			TreeAut::getInclusionStats(cntHits, cntMisses);
+			cntHits += workerStats_.cntInclusionHits;
+			cntMisses += workerStats_.cntInclusionMisses;
+			FA_DEBUG_AT(1, "inclusion cache: " << cntHits << " hit(s), "
+				<< cntMisses << " miss(es)");
+			FA_DEBUG_AT(1, "search strategy " << execMan_.strategyName() << ": "
+				<< execMan_.statesEvaluated() << " state(s) evaluated, at most "
+				<< execMan_.maxQueueSize() << " state(s) queued");
 		}
 		catch (const ProgramError& e)
 		{ }
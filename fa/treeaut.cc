@@ -29,6 +29,7 @@
 #include "treeaut.hh"
 #include "simalg.hh"
 #include "antichainext.hh"
+#include "inclusioncache.hh"
 
 struct LhsEnv
 {
@@ -68,7 +69,7 @@ struct LhsEnv
 	static bool sim(
 		const LhsEnv&                              e1,
 		const LhsEnv&                              e2,
-		const std::vector<std::vector<bool>>&      sim)
+		const BitMatrix&                           sim)
 	{
 		if ((e1.index != e2.index) || (e1.data.size() != e2.data.size()))
 			return false;
@@ -85,7 +86,7 @@ struct LhsEnv
 	static bool eq(
 		const LhsEnv&                           e1,
 		const LhsEnv&                           e2,
-		const std::vector<std::vector<bool>>&   sim)
+		const BitMatrix&                        sim)
 	{
 		if ((e1.index != e2.index) || (e1.data.size() != e2.data.size()))
 			return false;
@@ -173,7 +174,7 @@ struct Env
 	static bool sim(
 		const Env&                              e1,
 		const Env&                              e2,
-		const std::vector<std::vector<bool>>&   sim)
+		const BitMatrix&                        sim)
 	{
 		return (e1.label == e2.label) && LhsEnv::sim(*e1.lhs, *e2.lhs, sim);
 	}
@@ -181,7 +182,7 @@ struct Env
 	static bool eq(
 		const Env&                              e1,
 		const Env&                              e2,
-		const std::vector<std::vector<bool>>&   sim)
+		const BitMatrix&                        sim)
 	{
 		return (e1.label == e2.label) && LhsEnv::eq(*e1.lhs, *e2.lhs, sim);
 	}
@@ -232,7 +233,7 @@ void TA<T>::downwardTranslation(
 
 template <class T>
 void TA<T>::downwardSimulation(
-	std::vector<std::vector<bool>>&   rel,
+	BitMatrix&                        rel,
 	const Index<size_t>&              stateIndex) const
 {
 	LTS lts;
@@ -249,10 +250,10 @@ template <class T>
 void TA<T>::upwardTranslation(
 	LTS&                                    lts,
 	std::vector<std::vector<size_t>>&       part,
-	std::vector<std::vector<bool>>&         rel,
+	BitMatrix&                              rel,
 	const Index<size_t>&                    stateIndex,
 	const Index<T>&                         labelIndex,
-	const std::vector<std::vector<bool>>&   sim) const
+	const BitMatrix&                        sim) const
 {
 	std::set<LhsEnv> lhsEnvSet;
 	std::map<Env, size_t> envMap;
@@ -310,8 +311,7 @@ void TA<T>::upwardTranslation(
 		}
 	}
 
-	rel = std::vector<std::vector<bool>>(
-		part.size() + 2, std::vector<bool>(part.size() + 2, false));
+	rel.assign(part.size() + 2, false);
 
 	// 0 non-accepting, 1 accepting, 2 .. environments
 	rel[0][0] = true;
@@ -329,15 +329,15 @@ void TA<T>::upwardTranslation(
 
 template <class T>
 void TA<T>::upwardSimulation(
-	std::vector<std::vector<bool>>&         rel,
+	BitMatrix&                              rel,
 	const Index<size_t>&                    stateIndex,
-	const std::vector<std::vector<bool>>&   param) const
+	const BitMatrix&                        param) const
 {
 	LTS lts;
 	Index<T> labelIndex;
 	this->buildLabelIndex(labelIndex);
 	std::vector<std::vector<size_t>> part;
-	std::vector<std::vector<bool>> initRel;
+	BitMatrix initRel;
 	this->upwardTranslation(lts, part, initRel, stateIndex, labelIndex, param);
 	OLRTAlgorithm alg(lts);
 	// accepting states to block 1
@@ -355,24 +355,19 @@ void TA<T>::upwardSimulation(
 
 template <class T>
 void TA<T>::combinedSimulation(
-	std::vector<std::vector<bool>>&           dst,
-	const std::vector<std::vector<bool>>&     dwn,
-	const std::vector<std::vector<bool>>&     up)
+	BitMatrix&                                dst,
+	const BitMatrix&                          dwn,
+	const BitMatrix&                          up)
 {
 	size_t size = dwn.size();
-	std::vector<std::vector<bool> > dut(size, std::vector<bool>(size, false));
+	BitMatrix dut(size, false);
 	for (size_t i = 0; i < size; ++i)
 	{
 		for (size_t j = 0; j < size; ++j)
 		{
-			for (size_t k = 0; k < size; ++k)
-			{
-				if (dwn[i][k] && up[j][k])
-				{
-					dut[i][j] = true;
-					break;
-				}
-			}
+			// is there any k such that dwn[i][k] && up[j][k]?
+			if (dwn.rowsIntersect(i, up, j))
+				dut[i][j] = true;
 		}
 	}
 	dst = dut;
@@ -380,25 +375,107 @@ void TA<T>::combinedSimulation(
 	{
 		for (size_t j = 0; j < size; ++j)
 		{
-			if (!dst[i][j])
-				continue;
+			// dwn[j][k] must imply dut[i][k] for all k
+			if (dst[i][j] && !dwn.rowSubseteq(j, dut, i))
+				dst[i][j] = false;
+		}
+	}
+}
 
-			for (size_t k = 0; k < size; ++k)
-			{
-				if (dwn[j][k] && !dut[i][k])
-				{
-					dst[i][j] = false;
-					break;
-				}
-			}
+namespace
+{
+	template <class T>
+	InclusionCache<T>& inclusionCache()
+	{
+		static InclusionCache<T> cache;
+		return cache;
+	}
+} // namespace
+
+template <class T>
+size_t TA<T>::structuralHash() const
+{
+	size_t h = boost::hash_range(finalStates_.begin(), finalStates_.end());
+	for (const TransIDPair* trans : this->transitions)
+	{	// transitions are interned, their addresses identify them
+		boost::hash_combine(h, trans);
+	}
+
+	return h;
+}
+
+template <class T>
+bool TA<T>::structurallyEqual(const TA<T>& rhs) const
+{
+	return (this->backend == rhs.backend)
+		&& (nextState_ == rhs.nextState_)
+		&& (finalStates_ == rhs.finalStates_)
+		&& (this->transitions == rhs.transitions);
+}
+
+template <class T>
+std::shared_ptr<TA<T>> TA<T>::hashCons(const std::shared_ptr<TA<T>>& ta)
+{
+	// Assertions
+	assert(nullptr != ta);
+
+	Backend& backend = *ta->backend;
+	const size_t h = ta->structuralHash();
+
+	auto range = backend.consTable.equal_range(h);
+	for (auto i = range.first; i != range.second; )
+	{
+		const std::shared_ptr<TA<T>> other = i->second.lock();
+		if (nullptr == other)
+		{	// the automaton is gone
+			i = backend.consTable.erase(i);
+			continue;
+		}
+
+		if ((other == ta) || other->structurallyEqual(*ta))
+			return other;
+
+		++i;
+	}
+
+	backend.consTable.insert(std::make_pair(h, std::weak_ptr<TA<T>>(ta)));
+	if (backend.consSweepSize <= backend.consTable.size())
+	{	// drop the entries of automata that are gone
+		for (auto i = backend.consTable.begin(); i != backend.consTable.end(); )
+		{
+			if (i->second.expired())
+				i = backend.consTable.erase(i);
+			else
+				++i;
 		}
+
+		backend.consSweepSize = std::max(backend.consSweepSize,
+			2 * backend.consTable.size());
 	}
+
+	return ta;
 }
 
 template <class T>
 bool TA<T>::subseteq(const TA<T>& a, const TA<T>& b)
 {
-	return AntichainExt<T>::subseteq(a, b);
+	if (&a == &b)
+		return true;
+
+	return inclusionCache<T>().subseteq(a, b);
+}
+
+template <class T>
+void TA<T>::invalidateInclusion(const TA<T>& ta)
+{
+	inclusionCache<T>().invalidate(ta);
+}
+
+template <class T>
+void TA<T>::getInclusionStats(size_t& hits, size_t& misses)
+{
+	hits = inclusionCache<T>().hits();
+	misses = inclusionCache<T>().misses();
 }
 
 // this is really sad :-(
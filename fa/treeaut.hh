@@ -26,9 +26,13 @@
 #include <map>
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 // Forester headers
+#include "bitmatrix.hh"
 #include "cache.hh"
 #include "lts.hh"
 #include "streams.hh"
@@ -210,7 +214,7 @@ public:   // methods
 
 	bool llhsLessThan(
 		const TT&                                 rhs,
-		const std::vector<std::vector<bool>>&     cons,
+		const BitMatrix&                          cons,
 		const Index<size_t>&                      stateIndex) const
 	{
 		if (this->label() != rhs.label())
@@ -225,6 +229,10 @@ public:   // methods
 };
 
 
+template <class T>
+class LabelIndex;
+
+
 /**
  * @brief  Tree automaton
  */
@@ -253,9 +261,17 @@ public:   // data types
 		typename TTBase<T>::lhs_cache_type lhsCache;
 		trans_cache_type transCache;
 
+		/// automata shared by hashCons(), keyed by their structural hash
+		std::unordered_multimap<size_t, std::weak_ptr<TA<T>>> consTable;
+
+		/// the size of @p consTable at which its expired entries are swept
+		size_t consSweepSize;
+
 		Backend() :
 			lhsCache{},
-			transCache{}
+			transCache{},
+			consTable{},
+			consSweepSize(1024)
 		{ }
 	};
 
@@ -377,6 +393,9 @@ private:  // data members
 	size_t nextState_;
 	std::set<size_t> finalStates_;
 
+	/// the transitions grouped by their labels, built lazily by labelIndex()
+	mutable std::shared_ptr<const LabelIndex<T>> labelIndex_;
+
 public:   // data members
 
 	Backend* backend;
@@ -391,6 +410,7 @@ public:
 		Backend&             backend) :
 		nextState_(0),
 		finalStates_{},
+		labelIndex_{},
 		backend(&backend),
 		maxRank(0),
 		transitions{}
@@ -401,6 +421,7 @@ public:
 		bool                 copyFinalStates = true) :
 		nextState_(ta.nextState_),
 		finalStates_{},
+		labelIndex_(ta.labelIndex_),
 		backend(ta.backend),
 		maxRank(ta.maxRank),
 		transitions(ta.transitions)
@@ -423,6 +444,7 @@ public:
 		bool                 copyFinalStates = true) :
 		nextState_(ta.nextState_),
 		finalStates_(),
+		labelIndex_{},
 		backend(ta.backend),
 		maxRank(ta.maxRank),
 		transitions()
@@ -456,6 +478,7 @@ public:
 		TransIDPair* x = this->transCache().lookup(t);
 		if (this->transitions.insert(x).second)
 		{
+			labelIndex_.reset();
 			if (t.lhs().size() > this->maxRank)
 				this->maxRank = t.lhs().size();
 		} else
@@ -547,6 +570,7 @@ public:
 		this->backend = rhs.backend;
 		this->transitions = rhs.transitions;
 		finalStates_ = rhs.finalStates_;
+		labelIndex_ = rhs.labelIndex_;
 
 		for (TransIDPair* trans : this->transitions)
 		{	// copy transitions
@@ -560,6 +584,7 @@ public:
 	{
 		this->maxRank = 0;
 		nextState_ = 0;
+		labelIndex_.reset();
 		for (TransIDPair* trans : this->transitions)
 		{
 			this->transCache().release(trans);
@@ -668,6 +693,19 @@ public:
 		return cache;
 	}
 
+	/**
+	 * @brief  Gets the transitions of the TA grouped by their labels
+	 *
+	 * The index is built by buildLTCache() on the first call and kept until the
+	 * transitions of the TA change, so that products of automata which are no
+	 * longer modified do not rebuild it again and again.  Holding the returned
+	 * pointer keeps the index alive even if the TA is modified, but not the
+	 * transitions it points to.
+	 *
+	 * @returns  The cached label index of the TA
+	 */
+	std::shared_ptr<const LabelIndex<T>> labelIndex() const;
+
 	void buildBUCache(bu_cache_type& cache) const
 	{
 		std::unordered_set<size_t> s;
@@ -814,27 +852,44 @@ public:
 		const Index<T>&                           labelIndex) const;
 
 	void downwardSimulation(
-		std::vector<std::vector<bool>>&           rel,
+		BitMatrix&                                rel,
 		const Index<size_t>&                      stateIndex) const;
 
 	void upwardTranslation(
 		LTS&                                      lts,
 		std::vector<std::vector<size_t>>&         part,
-		std::vector<std::vector<bool>>&           rel,
+		BitMatrix&                                rel,
 		const Index<size_t>&                      stateIndex,
 		const Index<T>&                           labelIndex,
-		const std::vector<std::vector<bool>>&     sim) const;
+		const BitMatrix&                          sim) const;
 
 	void upwardSimulation(
-		std::vector<std::vector<bool>>&           rel,
+		BitMatrix&                                rel,
 		const Index<size_t>&                      stateIndex,
-		const std::vector<std::vector<bool>>&     param) const;
+		const BitMatrix&                          param) const;
 
 	static void combinedSimulation(
-		std::vector<std::vector<bool>>&           dst,
-		const std::vector<std::vector<bool>>&     dwn,
-		const std::vector<std::vector<bool>>&     up);
+		BitMatrix&                                dst,
+		const BitMatrix&                          dwn,
+		const BitMatrix&                          up);
 
+	/**
+	 * @brief  Computes the bottom-up product of two sets of transitions
+	 *
+	 * The product is computed using a worklist of newly created product states.
+	 * Each new product state only triggers the pairs of transitions that have
+	 * it at some position of their left-hand sides, found by (label, arity,
+	 * position, state).  The functor @p f is called exactly once for each pair
+	 * of transitions with the same label whose left-hand sides are made of
+	 * product states.
+	 *
+	 * @param[in]  cache1       Transitions of the first TA, grouped by labels
+	 * @param[in]  cache2       Transitions of the second TA, grouped by labels
+	 * @param[in]  f            The functor called as f(t1, t2, lhs, rhs)
+	 * @param[in]  stateOffset  The number of the first product state
+	 *
+	 * @returns  The count of product states
+	 */
 	template <class F>
 	static size_t buProduct(
 		const lt_cache_type&                      cache1,
@@ -842,61 +897,113 @@ public:
 		F                                         f,
 		size_t                                    stateOffset = 0)
 	{
-		std::unordered_map<std::pair<size_t, size_t>, size_t, boost::hash<std::pair<size_t, size_t>>> product;
-		for (typename lt_cache_type::const_iterator i = cache1.begin(); i != cache1.end(); ++i)
+		typedef std::pair<size_t, size_t> StatePair;
+		typedef std::pair<const Transition*, const Transition*> TransPair;
+		typedef std::pair<std::pair<T, size_t>, StatePair> IndexKey;
+
+		std::unordered_map<StatePair, size_t, boost::hash<StatePair>> product;
+		std::vector<StatePair> workset;
+		std::unordered_set<TransPair, boost::hash<TransPair>> fired;
+
+		// transitions of the first TA by the states of their left-hand sides
+		std::unordered_map<size_t, std::vector<std::pair<size_t, const Transition*>>> index1;
+		// transitions of the second TA by (label, arity, position, state)
+		std::unordered_map<IndexKey, std::vector<const Transition*>, boost::hash<IndexKey>> index2;
+		// leaves of the second TA by label
+		std::unordered_map<T, std::vector<const Transition*>> leaves2;
+
+		for (typename lt_cache_type::const_iterator i = cache2.begin(); i != cache2.end(); ++i)
 		{
-			if (!i->second.front()->lhs().empty())
+			if (cache1.end() == cache1.find(i->first))
 				continue;
 
-			typename lt_cache_type::const_iterator j = cache2.find(i->first);
-			if (j == cache2.end())
+			for (const Transition* t : i->second)
+			{
+				if (t->lhs().empty())
+				{
+					leaves2[i->first].push_back(t);
+					continue;
+				}
+
+				for (size_t m = 0; m < t->lhs().size(); ++m)
+				{
+					index2[IndexKey(std::make_pair(i->first, t->lhs().size()),
+						StatePair(m, t->lhs()[m]))].push_back(t);
+				}
+			}
+		}
+
+		// fires the pair of transitions if all its left-hand side is in the product
+		auto fire = [&](const Transition* t1, const Transition* t2)
+		{
+			assert(t1->lhs().size() == t2->lhs().size());
+			if (fired.count(TransPair(t1, t2)))
+				return;
+
+			std::vector<size_t> lhs;
+			lhs.reserve(t1->lhs().size());
+			for (size_t m = 0; m < t1->lhs().size(); ++m)
+			{
+				auto n = product.find(StatePair(t1->lhs()[m], t2->lhs()[m]));
+				if (product.end() == n)
+					return;
+
+				lhs.push_back(n->second);
+			}
+
+			fired.insert(TransPair(t1, t2));
+
+			auto p = product.insert(std::make_pair(
+				StatePair(t1->rhs(), t2->rhs()), product.size() + stateOffset));
+			if (p.second)
+				workset.push_back(p.first->first);
+
+			f(t1, t2, lhs, p.first->second);
+		};
+
+		for (typename lt_cache_type::const_iterator i = cache1.begin(); i != cache1.end(); ++i)
+		{
+			if (cache2.end() == cache2.find(i->first))
 				continue;
 
-			for (typename std::vector<const Transition*>::const_iterator k = i->second.begin(); k != i->second.end(); ++k)
+			auto leaves = leaves2.find(i->first);
+			for (const Transition* t1 : i->second)
 			{
-				for (typename std::vector<const Transition*>::const_iterator l = j->second.begin(); l != j->second.end(); ++l)
+				if (!t1->lhs().empty())
 				{
-					std::pair<std::unordered_map<std::pair<size_t, size_t>, size_t, boost::hash<std::pair<size_t, size_t>>>::iterator, bool> p =
-						product.insert(std::make_pair(std::make_pair((*k)->rhs(), (*l)->rhs()), product.size() + stateOffset));
-					f(*k, *l, std::vector<size_t>(), p.first->second);
+					for (size_t m = 0; m < t1->lhs().size(); ++m)
+						index1[t1->lhs()[m]].push_back(std::make_pair(m, t1));
+
+					continue;
 				}
+
+				if (leaves2.end() == leaves)
+					continue;
+
+				for (const Transition* t2 : leaves->second)
+					fire(t1, t2);
 			}
 		}
-		bool changed = true;
-		while (changed)
+
+		while (!workset.empty())
 		{
-			changed = false;
-			for (typename lt_cache_type::const_iterator i = cache1.begin(); i != cache1.end(); ++i)
+			const StatePair state = workset.back();
+			workset.pop_back();
+
+			auto i = index1.find(state.first);
+			if (index1.end() == i)
+				continue;
+
+			for (const std::pair<size_t, const Transition*>& posTrans : i->second)
 			{
-				if (i->second.front()->lhs().empty())
+				const Transition* t1 = posTrans.second;
+				auto j = index2.find(IndexKey(std::make_pair(t1->label(),
+					t1->lhs().size()), StatePair(posTrans.first, state.second)));
+				if (index2.end() == j)
 					continue;
-				typename lt_cache_type::const_iterator j = cache2.find(i->first);
-				if (j == cache2.end())
-					continue;
-				for (typename std::vector<const Transition*>::const_iterator k = i->second.begin(); k != i->second.end(); ++k)
-				{
-					for (typename std::vector<const Transition*>::const_iterator l = j->second.begin(); l != j->second.end(); ++l)
-					{
-						assert((*k)->lhs().size() == (*l)->lhs().size());
-						std::vector<size_t> lhs;
-						for (size_t m = 0; m < (*k)->lhs().size(); ++m)
-						{
-							std::unordered_map<std::pair<size_t, size_t>, size_t, boost::hash<std::pair<size_t, size_t>>>::iterator n = product.find(
-								std::make_pair((*k)->lhs()[m], (*l)->lhs()[m])
-							);
-							if (n == product.end())
-								break;
-							lhs.push_back(n->second);
-						}
-						if (lhs.size() < (*k)->lhs().size())
-							continue;
-						std::pair<std::unordered_map<std::pair<size_t, size_t>, size_t, boost::hash<std::pair<size_t, size_t>>>::iterator, bool> p =
-							product.insert(std::make_pair(std::make_pair((*k)->rhs(), (*l)->rhs()), product.size() + stateOffset));
-						f(*k, *l, lhs, p.first->second);
-						if (p.second)
-							changed = true;
-					}
-				}
+
+				for (const Transition* t2 : j->second)
+					fire(t1, t2);
 			}
 		}
 
@@ -936,10 +1043,10 @@ public:
 		const TA<T>&                     src2,
 		size_t                           stateOffset = 0)
 	{
-		lt_cache_type cache1, cache2;
-		src1.buildLTCache(cache1);
-		src2.buildLTCache(cache2);
-		return TA<T>::buProduct(cache1, cache2, TA<T>::IntersectF(dst, src1, src2), stateOffset);
+		const std::shared_ptr<const LabelIndex<T>> index1 = src1.labelIndex();
+		const std::shared_ptr<const LabelIndex<T>> index2 = src2.labelIndex();
+		return TA<T>::buProduct(index1->byLabel(), index2->byLabel(),
+			TA<T>::IntersectF(dst, src1, src2), stateOffset);
 	}
 
 	struct PredicateF
@@ -969,10 +1076,11 @@ public:
 		std::vector<size_t>&                 dst,
 		const TA<T>&                         predicate) const
 	{
-		lt_cache_type cache1, cache2;
-		this->buildLTCache(cache1);
-		predicate.buildLTCache(cache2);
-		TA<T>::buProduct(cache1, cache2, TA<T>::PredicateF(dst, predicate));
+		const std::shared_ptr<const LabelIndex<T>> index1 = this->labelIndex();
+		const std::shared_ptr<const LabelIndex<T>> index2 =
+			predicate.labelIndex();
+		TA<T>::buProduct(index1->byLabel(), index2->byLabel(),
+			TA<T>::PredicateF(dst, predicate));
 	}
 
 
@@ -988,7 +1096,7 @@ public:
 		const Transition*                         t1,
 		const Transition*                         t2,
 		F                                         funcMatch,
-		const std::vector<std::vector<bool>>&     mat,
+		const BitMatrix&                          mat,
 		const Index<size_t>&                      stateIndex)
 	{
 		// Preconditions
@@ -1015,14 +1123,14 @@ public:
 	// currently erases '1' from the relation
 	template <class F>
 	void heightAbstraction(
-		std::vector<std::vector<bool>>&            result,
+		BitMatrix&                                 result,
 		size_t                                     height,
 		F                                          f,
 		const Index<size_t>&                       stateIndex) const
 	{
 		td_cache_type cache = this->buildTDCache();
 
-		std::vector<std::vector<bool>> tmp;
+		BitMatrix tmp;
 
 		while (height--)
 		{
@@ -1062,20 +1170,14 @@ public:
 			}
 		}
 
-		for (size_t i = 0; i < result.size(); ++i)
-		{
-			for (size_t j = 0; j < i; ++j)
-			{
-				if (!result[i][j])
-					result[j][i] = false;
-				if (!result[j][i])
-					result[i][j] = false;
-			}
-		}
+		// keep only the symmetric part of the relation
+		BitMatrix inv;
+		result.transpose(inv);
+		result &= inv;
 	}
 
 	void predicateAbstraction(
-		std::vector<std::vector<bool>>&      result,
+		BitMatrix&                           result,
 		const TA<T>&                         predicate,
 		const Index<size_t>&                 stateIndex) const
 	{
@@ -1104,7 +1206,7 @@ public:
 	// collapses states according to a given relation
 	TA<T>& collapsed(
 		TA<T>&                                   dst,
-		const std::vector<std::vector<bool>>&    rel,
+		const BitMatrix&                         rel,
 		const Index<size_t>&                     stateIndex) const
 	{
 		std::vector<size_t> headIndex;
@@ -1288,7 +1390,7 @@ public:
 
 	TA<T>& downwardSieve(
 		TA<T>&                                    dst,
-		const std::vector<std::vector<bool>>&     cons,
+		const BitMatrix&                          cons,
 		const Index<size_t>&                      stateIndex) const
 	{
 		td_cache_type cache = this->buildTDCache();
@@ -1326,11 +1428,11 @@ public:
 
 	TA<T>& minimized(
 		TA<T>&                                   dst,
-		const std::vector<std::vector<bool>>&    cons,
+		const BitMatrix&                         cons,
 		const Index<size_t>&                     stateIndex) const
 	{
 		typename TA<T>::Backend backend;
-		std::vector<std::vector<bool>> dwn;
+		BitMatrix dwn;
 		this->downwardSimulation(dwn, stateIndex);
 		utils::relAnd(dwn, cons, dwn);
 		TA<T> tmp1(backend), tmp2(backend), tmp3(backend);
@@ -1342,11 +1444,11 @@ public:
 		Index<size_t> stateIndex;
 		this->buildSortedStateIndex(stateIndex);
 		typename TA<T>::Backend backend;
-		std::vector<std::vector<bool> > dwn;
+		BitMatrix dwn;
 		this->downwardSimulation(dwn, stateIndex);
-		std::vector<std::vector<bool> > up;
+		BitMatrix up;
 		this->upwardSimulation(up, stateIndex, dwn);
-		std::vector<std::vector<bool> > rel;
+		BitMatrix rel;
 		TA<T>::combinedSimulation(rel, dwn, up);
 		TA<T> tmp(backend);
 		return this->collapsed(tmp, rel, stateIndex).minimized(dst);
@@ -1356,12 +1458,54 @@ public:
 	{
 		Index<size_t> stateIndex;
 		this->buildSortedStateIndex(stateIndex);
-		std::vector<std::vector<bool> > cons(stateIndex.size(), std::vector<bool>(stateIndex.size(), true));
+		BitMatrix cons(stateIndex.size(), true);
 		return this->minimized(dst, cons, stateIndex);
 	}
 
+	/**
+	 * @brief  Computes a hash of the final states and transitions
+	 *
+	 * Transitions are interned in the backend, so structurally identical
+	 * automata in the same backend have the same hash.
+	 */
+	size_t structuralHash() const;
+
+	/**
+	 * @brief  Checks whether the automata have the same states and transitions
+	 */
+	bool structurallyEqual(const TA<T>& rhs) const;
+
+	/**
+	 * @brief  Returns the shared instance of the automaton @p ta
+	 *
+	 * Returns a previously passed automaton that is structurally identical to
+	 * @p ta, if it is still alive, and @p ta itself otherwise.  Identical
+	 * automata thus become equal by pointer.  Shared automata must not be
+	 * modified in place.
+	 */
+	static std::shared_ptr<TA<T>> hashCons(const std::shared_ptr<TA<T>>& ta);
+
+	/**
+	 * @brief  Checks language inclusion of @p a in @p b
+	 *
+	 * Results are memoised by the structure of both automata, see
+	 * InclusionCache.
+	 */
 	static bool subseteq(const TA<T>& a, const TA<T>& b);
 
+	/**
+	 * @brief  Drops the memoised results of inclusion checks of @p ta
+	 *
+	 * To be called before an automaton that is checked against repeatedly
+	 * is modified.
+	 */
+	static void invalidateInclusion(const TA<T>& ta);
+
+	/**
+	 * @brief  Retrieves the count of hits and misses of the inclusion cache
+	 */
+	static void getInclusionStats(size_t& hits, size_t& misses);
+
 
 	/**
 	 * @brief  Creates a new TA with renamed states
@@ -1744,4 +1888,60 @@ public:
 	};
 };
 
+
+/**
+ * @brief  Immutable index of the transitions of a tree automaton by labels
+ *
+ * Holds the transitions grouped by their labels, as built by
+ * TA::buildLTCache().  The index is cached by TA::labelIndex().
+ */
+template <class T>
+class LabelIndex
+{
+public:   // data types
+
+	typedef typename TA<T>::Transition Transition;
+
+	typedef typename TA<T>::lt_cache_type lt_cache_type;
+
+private:  // data members
+
+	/// the transitions, grouped by their labels
+	lt_cache_type byLabel_;
+
+private:  // methods
+
+	LabelIndex(const LabelIndex&);
+	LabelIndex& operator=(const LabelIndex&);
+
+public:   // methods
+
+	explicit LabelIndex(const TA<T>& ta) :
+		byLabel_{}
+	{
+		ta.buildLTCache(byLabel_);
+	}
+
+	/**
+	 * @brief  Gets the transitions grouped by their labels
+	 */
+	const lt_cache_type& byLabel() const
+	{
+		return byLabel_;
+	}
+};
+
+
+template <class T>
+std::shared_ptr<const LabelIndex<T>> TA<T>::labelIndex() const
+{
+	if (nullptr == labelIndex_)
+	{
+		labelIndex_ = std::shared_ptr<const LabelIndex<T>>(
+			new LabelIndex<T>(*this));
+	}
+
+	return labelIndex_;
+}
+
 #endif
@@ -942,6 +942,36 @@ void cl_chain_append(
         struct cl_code_listener         *chain,
         struct cl_code_listener         *listener);
 
+/**
+ * snapshot of the code listener events, as written by the "snapshot" listener
+ */
+struct cl_snapshot;
+
+/**
+ * map a snapshot written by the "snapshot" listener into memory
+ * @param file_name Name of the snapshot file.
+ * @return Returns NULL if the file could not be opened or mapped.
+ */
+struct cl_snapshot* cl_snapshot_open(const char *file_name);
+
+/**
+ * replay all events recorded in a snapshot, except for acknowledge()
+ * @param snapshot Object returned by cl_snapshot_open() function.
+ * @param listener Object ought to receive the events.
+ * @return Returns false if the snapshot is corrupted or of another version.
+ * @note The objects passed to the listener refer to the snapshot, so the
+ * snapshot may be closed only after the listener has been destroyed.
+ */
+bool cl_snapshot_replay(
+        struct cl_snapshot              *snapshot,
+        struct cl_code_listener         *listener);
+
+/**
+ * unmap a snapshot and free all objects loaded from it
+ * @param snapshot Object returned by cl_snapshot_open() function.
+ */
+void cl_snapshot_close(struct cl_snapshot *snapshot);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef H_GUARD_MEM_POOL_H
+#define H_GUARD_MEM_POOL_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+/**
+ * @file mempool.hh
+ * size-class pool allocator for small objects that are allocated and released
+ * frequently (heap entities, nodes of std::map and std::set, ...)
+ *
+ * Released blocks are kept in per-size free lists and recycled by subsequent
+ * allocations of the same size class.  The memory is never returned back to
+ * the system until the process ends.  The pool is not thread-safe.
+ */
+
+/// allocate a block of the given size, throw std::bad_alloc on failure
+void* poolAlloc(size_t size);
+
+/// release a block previously obtained by poolAlloc() with the same size
+void poolFree(void *ptr, size_t size);
+
+/// print statistics of the pool allocator, return false if nothing to print
+bool printMemPoolStats();
+
+/// STL allocator using poolAlloc() and poolFree() as the backend
+template <typename T>
+class PoolAllocator {
+    public:
+        typedef T                                   value_type;
+        typedef T                                  *pointer;
+        typedef const T                            *const_pointer;
+        typedef T                                  &reference;
+        typedef const T                            &const_reference;
+        typedef size_t                              size_type;
+        typedef ptrdiff_t                           difference_type;
+
+        template <typename U> struct rebind {
+            typedef PoolAllocator<U>                other;
+        };
+
+        PoolAllocator() { }
+
+        template <typename U> PoolAllocator(const PoolAllocator<U> &) { }
+
+        pointer address(reference ref) const {
+            return &ref;
+        }
+
+        const_pointer address(const_reference ref) const {
+            return &ref;
+        }
+
+        pointer allocate(size_type n, const void * /* hint */ = 0) {
+            return static_cast<pointer>(poolAlloc(n * sizeof(T)));
+        }
+
+        void deallocate(pointer ptr, size_type n) {
+            poolFree(ptr, n * sizeof(T));
+        }
+
+        size_type max_size() const {
+            return std::numeric_limits<size_type>::max() / sizeof(T);
+        }
+
+        void construct(pointer ptr, const_reference val) {
+            new (ptr) T(val);
+        }
+
+        void destroy(pointer ptr) {
+            ptr->~T();
+        }
+};
+
+template <typename T, typename U>
+inline bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    // all instances share the same pool
+    return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return false;
+}
+
+#endif /* H_GUARD_MEM_POOL_H */
@@ -154,6 +154,12 @@ class VarDb {
          */
         const Var& operator[](int uid) const;
 
+        /**
+         * switch the uid lookups to a dense table if the uids allow it
+         * @note useful only for builder, called once the storage is complete
+         */
+        void finalize();
+
         /**
          * return STL-like iterator to go through the container
          */
@@ -215,6 +221,12 @@ class TypeDb {
          */
         const struct cl_type* operator[](int) const;
 
+        /**
+         * switch the uid lookups to a dense table if the uids allow it
+         * @note useful only for builder, called once the storage is complete
+         */
+        void finalize();
+
         /**
          * return STL-like iterator to go through the container
          */
@@ -795,6 +807,12 @@ class FncDb {
          */
         const Fnc* operator[](int uid) const;
 
+        /**
+         * switch the uid lookups to a dense table if the uids allow it
+         * @note useful only for builder, called once the storage is complete
+         */
+        void finalize();
+
         /**
          * return STL-like iterator to go through all functions inside
          */
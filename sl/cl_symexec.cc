@@ -31,12 +31,26 @@
 #include "symdump.hh"
 #include "symexec.hh"
 #include "symproc.hh"
+#include "symprof.hh"
 #include "symstate.hh"
 #include "symtrace.hh"
 #include "util.hh"
 
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+#include <signal.h>
+#include <stdint.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <boost/foreach.hpp>
 
@@ -99,11 +113,298 @@ void execFnc(const CodeStorage::Fnc &fnc, bool lookForGlJunk = false)
     }
 }
 
+// /////////////////////////////////////////////////////////////////////////////
+// parallel execution of virtual roots in worker processes
+//
+// Each worker process records all messages it emits into a temporary file.
+// The parent process replays them through the code listener interface strictly
+// in the order of roots, so that the output does not depend on scheduling.
+// If a worker crashes, is killed, or exits with non-zero status, its root is
+// analyzed again in the parent process so that no diagnostics are lost.
+
+typedef std::vector<const CodeStorage::Fnc *> TFncList;
+
+struct RootWorker {
+    const CodeStorage::Fnc     *fnc;
+    FILE                       *msgs;
+    pid_t                       pid;
+    struct timeval              start;
+    float                       wallTime;
+    long                        maxRss;         ///< in KiB, as wait4() says
+    bool                        done;
+    bool                        inProcess;      ///< fork() or worker failed
+
+    RootWorker():
+        fnc(0),
+        msgs(0),
+        pid(-1),
+        wallTime(0.0),
+        maxRss(0L),
+        done(false),
+        inProcess(false)
+    {
+    }
+};
+
+/// file descriptor the current worker process records its messages to
+static int workerMsgFd = -1;
+
+void writeAll(const void *buf, size_t len)
+{
+    const char *ptr = static_cast<const char *>(buf);
+    while (len) {
+        const ssize_t rv = write(::workerMsgFd, ptr, len);
+        if (rv < 0) {
+            if (EINTR == errno)
+                continue;
+
+            // nothing better to do in a worker process
+            _exit(EXIT_FAILURE);
+        }
+
+        ptr += rv;
+        len -= rv;
+    }
+}
+
+void recordMsg(const char kind, const char *msg)
+{
+    const uint32_t len = strlen(msg);
+    writeAll(&kind, sizeof kind);
+    writeAll(&len, sizeof len);
+    writeAll(msg, len);
+}
+
+void recordDebug(const char *msg) { recordMsg('D', msg); }
+void recordWarn (const char *msg) { recordMsg('W', msg); }
+void recordError(const char *msg) { recordMsg('E', msg); }
+void recordNote (const char *msg) { recordMsg('N', msg); }
+
+void recordDie(const char *msg)
+{
+    recordMsg('X', msg);
+    _exit(EXIT_FAILURE);
+}
+
+/// replay messages recorded by a worker, return false if it ended by exception
+bool replayMsgs(FILE *fp, std::string *pExcMsg)
+{
+    rewind(fp);
+
+    char kind;
+    uint32_t len;
+    while (1 == fread(&kind, sizeof kind, 1, fp)
+            && 1 == fread(&len, sizeof len, 1, fp))
+    {
+        std::string msg(len, '\0');
+        if (len && 1 != fread(&msg[0], len, 1, fp))
+            break;
+
+        switch (kind) {
+            case 'D': cl_debug(msg.c_str());   break;
+            case 'W': cl_warn (msg.c_str());   break;
+            case 'E': cl_error(msg.c_str());   break;
+            case 'N': cl_note (msg.c_str());   break;
+            case 'X': cl_die  (msg.c_str());   break;
+
+            case 'T':
+                *pExcMsg = msg;
+                return false;
+
+            default:
+                CL_BREAK_IF("replayMsgs() got an invalid record");
+                return true;
+        }
+    }
+
+    return true;
+}
+
+void runRootWorker(const RootWorker &wrk)
+{
+    // redirect all messages of this process to the temporary file
+    ::workerMsgFd = fileno(wrk.msgs);
+    struct cl_init_data init;
+    init.debug          = recordDebug;
+    init.warn           = recordWarn;
+    init.error          = recordError;
+    init.note           = recordNote;
+    init.die            = recordDie;
+    init.debug_level    = cl_debug_level();
+    cl_global_init(&init);
+
+    try {
+        execFnc(*wrk.fnc);
+    }
+    catch (const std::runtime_error &e) {
+        // let the parent process decide what to do with the exception
+        recordMsg('T', e.what());
+    }
+
+    if (Trace::Globals::alive()) {
+        // plot the trace graphs of this worker before it vanishes
+        Trace::GraphProxy *glProxy = Trace::Globals::instance()->glProxy();
+        glProxy->plotAll();
+    }
+
+    // avoid running any cleanup of the parent process (e.g. that of gcc)
+    _exit(EXIT_SUCCESS);
+}
+
+void spawnRootWorker(RootWorker &wrk)
+{
+    gettimeofday(&wrk.start, 0);
+    wrk.msgs = tmpfile();
+    if (wrk.msgs) {
+        // make sure nothing buffered gets duplicated into the worker
+        fflush(0);
+        wrk.pid = fork();
+        if (!wrk.pid)
+            runRootWorker(wrk);
+    }
+
+    if (wrk.msgs && 0 < wrk.pid)
+        return;
+
+    // fallback to sequential execution once it is the turn of this root
+    CL_DEBUG_MSG(locationOf(*wrk.fnc),
+            "failed to spawn a worker process for " << nameOf(*wrk.fnc) << "()");
+    wrk.inProcess = true;
+    wrk.done = true;
+}
+
+/// the results of the worker are lost, analyze the root sequentially instead
+void failRootWorker(RootWorker &wrk, const char *why)
+{
+    CL_DEBUG_MSG(locationOf(*wrk.fnc), "worker process for "
+            << nameOf(*wrk.fnc) << "() " << why
+            << ", the root will be analyzed again in-process");
+
+    wrk.inProcess = true;
+    wrk.done = true;
+}
+
+void reapRootWorker(std::vector<RootWorker> &workers)
+{
+    int status;
+    struct rusage usage;
+    pid_t pid;
+    while (-1 == (pid = wait4(-1, &status, 0, &usage)) && EINTR == errno)
+        ;
+
+    if (pid <= 0) {
+        // no child to wait for (ECHILD), none of the workers can finish now
+        BOOST_FOREACH(RootWorker &wrk, workers)
+            if (0 < wrk.pid && !wrk.done)
+                failRootWorker(wrk, "could not be waited for");
+
+        return;
+    }
+
+    BOOST_FOREACH(RootWorker &wrk, workers) {
+        if (wrk.pid != pid || wrk.done)
+            continue;
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+            // crashed, killed, or failed to record its messages
+            failRootWorker(wrk, "exited abnormally");
+            return;
+        }
+
+        struct timeval end;
+        gettimeofday(&end, 0);
+        wrk.wallTime = (end.tv_sec - wrk.start.tv_sec)
+            + (end.tv_usec - wrk.start.tv_usec) / 1e6;
+
+        wrk.maxRss = usage.ru_maxrss;
+        wrk.done = true;
+        return;
+    }
+}
+
+void killRootWorkers(std::vector<RootWorker> &workers)
+{
+    BOOST_FOREACH(RootWorker &wrk, workers) {
+        if (0 < wrk.pid && !wrk.done) {
+            kill(wrk.pid, SIGKILL);
+            waitpid(wrk.pid, 0, 0);
+        }
+
+        if (wrk.msgs)
+            fclose(wrk.msgs);
+    }
+}
+
+void printRootWorkerStats(const std::vector<RootWorker> &workers)
+{
+    BOOST_FOREACH(const RootWorker &wrk, workers) {
+        if (wrk.inProcess || !wrk.done)
+            continue;
+
+        CL_NOTE_MSG(locationOf(*wrk.fnc), "virtual root " << nameOf(*wrk.fnc)
+                << "() analyzed in " << std::fixed << std::setprecision(3)
+                << wrk.wallTime << " s, peak memory usage: "
+                << (wrk.maxRss >> /* MiB */ 10) << " MB");
+    }
+}
+
+void execVirtualRootsParallel(const TFncList &roots, const unsigned maxWorkers)
+{
+    const unsigned cnt = roots.size();
+    std::vector<RootWorker> workers(cnt);
+    for (unsigned i = 0; i < cnt; ++i)
+        workers[i].fnc = roots[i];
+
+    unsigned cntSpawned = 0U;
+    unsigned cntReplayed = 0U;
+    unsigned cntRunning = 0U;
+    std::string excMsg;
+
+    while (cntReplayed < cnt) {
+        // keep the pool of workers busy
+        while (cntSpawned < cnt && cntRunning < maxWorkers) {
+            RootWorker &wrk = workers[cntSpawned++];
+            spawnRootWorker(wrk);
+            if (!wrk.inProcess)
+                ++cntRunning;
+        }
+
+        if (!workers[cntReplayed].done) {
+            // wait for any worker to finish
+            reapRootWorker(workers);
+            cntRunning = 0U;
+            BOOST_FOREACH(const RootWorker &wrk, workers)
+                if (0 < wrk.pid && !wrk.done)
+                    ++cntRunning;
+
+            continue;
+        }
+
+        // replay the results of finished roots in the order of roots
+        RootWorker &wrk = workers[cntReplayed++];
+        if (wrk.inProcess) {
+            execFnc(*wrk.fnc);
+            printMemUsage("execFnc");
+            continue;
+        }
+
+        if (!replayMsgs(wrk.msgs, &excMsg)) {
+            // the exception would stop the sequential analysis at this point
+            killRootWorkers(workers);
+            throw std::runtime_error(excMsg);
+        }
+    }
+
+    printRootWorkerStats(workers);
+    killRootWorkers(workers);
+}
+
 void execVirtualRoots(const CodeStorage::Storage &stor)
 {
     namespace CG = CodeStorage::CallGraph;
 
     // go through all root nodes
+    TFncList roots;
     const CG::Graph &cg = stor.callGraph;
     BOOST_FOREACH(const CG::Node *node, cg.roots) {
         const CodeStorage::Fnc &fnc = *node->fnc;
@@ -113,8 +414,26 @@ void execVirtualRoots(const CodeStorage::Storage &stor)
         CL_DEBUG_MSG(lw, nameOf(fnc)
                 << "() is defined, but not called from anywhere");
 
+        roots.push_back(&fnc);
+    }
+
+    const int maxWorkers = GlConf::data.parallelRoots;
+    if (1 < roots.size() && 1 < maxWorkers) {
+        if (GlConf::data.fixedPoint)
+            CL_WARN("dump_fixed_point is not supported with parallel_roots");
+        else if (Profile::enabled())
+            CL_WARN("profile is not supported with parallel_roots");
+        else {
+            CL_DEBUG("analyzing " << roots.size() << " virtual roots using "
+                    << maxWorkers << " worker process(es)...");
+            execVirtualRootsParallel(roots, maxWorkers);
+            return;
+        }
+    }
+
+    BOOST_FOREACH(const CodeStorage::Fnc *fnc, roots) {
         // perform symbolic execution for a virtual root
-        execFnc(fnc);
+        execFnc(*fnc);
         printMemUsage("execFnc");
     }
 }
@@ -154,6 +473,11 @@ void clEasyRun(const CodeStorage::Storage &stor, const char *configString)
     // read parameters of symbolic execution
     GlConf::loadConfigString(configString);
 
+    const std::string &profile = GlConf::data.profile;
+    if (!profile.empty())
+        // start collecting the per-function and per-block profile
+        Profile::enable();
+
     // run symbolic execution
     try {
         launchSymExec(stor);
@@ -180,5 +504,8 @@ void clEasyRun(const CodeStorage::Storage &stor, const char *configString)
         printMemUsage("Trace::Globals::cleanup");
     }
 
+    if (!profile.empty())
+        Profile::writeJson(profile);
+
     printPeakMemUsage();
 }
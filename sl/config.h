@@ -190,6 +190,14 @@
  */
 #define SE_DUMP_TRACE_GRAPHS                1
 
+/**
+ * if non-zero, merge chains of trace graph nodes that represent instructions,
+ * conditions, and clone operations, keeping only a sparse skeleton of the
+ * trace graph;  at most SE_SPARSE_TRACE_GRAPH nodes are merged into one, which
+ * then serves as a checkpoint
+ */
+#define SE_SPARSE_TRACE_GRAPH               0
+
 /**
  * - 0 ... kill local variables only on stack frame destruction
  * - 1 ... kill local variables as soon as they become dead
@@ -293,11 +301,22 @@
  */
 #define SH_COPY_ON_WRITE                    1
 
+/**
+ * if 1, use persistent containers for the databases shared by SH_COPY_ON_WRITE,
+ * so that a change after copy of SymHeap copies O(log n) nodes, not everything
+ */
+#define SH_PERSISTENT_CONTAINERS            1
+
 /**
  * if 1, do not destroy fields immediately as they become unused
  */
 #define SH_DELAYED_FIELDS_DESTRUCTION       1
 
+/**
+ * if 1, allocate heap entities and nodes of per-heap containers from a pool
+ */
+#define SH_POOL_ALLOCATOR                   1
+
 /**
  * if more than zero, jump to debugger as soon as N graph of the same name has
  * been plotted
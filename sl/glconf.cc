@@ -25,9 +25,12 @@
 #include <cl/cl_msg.hh>
 
 #include <algorithm>
+#include <cstdlib>
 #include <map>
 #include <vector>
 
+#include <unistd.h>
+
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/foreach.hpp>
@@ -94,12 +97,46 @@ void handleOOM(const string &name, const string &value)
     data.oomSimulation = true;
 }
 
+void handleParallelRoots(const string &name, const string &value)
+{
+    if (value.empty()) {
+        // use all available CPUs by default
+        const long cnt = sysconf(_SC_NPROCESSORS_ONLN);
+        data.parallelRoots = (0 < cnt) ? cnt : 1;
+        return;
+    }
+
+    const int cnt = atoi(value.c_str());
+    if (cnt <= 0) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+        return;
+    }
+
+    data.parallelRoots = cnt;
+}
+
+void handleProfile(const string &name, const string &value)
+{
+    if (value.empty()) {
+        CL_WARN("ignoring option \"" << name << "\" without a valid value");
+        return;
+    }
+
+    data.profile = value;
+}
+
 void handleTrackUninit(const string &name, const string &value)
 {
     assumeNoValue(name, value);
     data.trackUninit = true;
 }
 
+void handleWtoScheduler(const string &name, const string &value)
+{
+    assumeNoValue(name, value);
+    data.wtoScheduler = true;
+}
+
 ConfigStringParser::ConfigStringParser()
 {
     tbl_["dump_fixed_point"]        = handleDumpFixedPoint;
@@ -107,7 +144,10 @@ ConfigStringParser::ConfigStringParser()
     tbl_["no_error_recovery"]       = handleNoErrorRecovery;
     tbl_["no_plot"]                 = handleNoPlot;
     tbl_["oom"]                     = handleOOM;
+    tbl_["parallel_roots"]          = handleParallelRoots;
+    tbl_["profile"]                 = handleProfile;
     tbl_["track_uninit"]            = handleTrackUninit;
+    tbl_["wto_scheduler"]           = handleWtoScheduler;
 }
 
 void ConfigStringParser::handleRawOption(const string &raw) const
@@ -35,7 +35,10 @@ struct Options {
     bool oomSimulation;     ///< enable/disable @b oom @b simulation mode
     bool skipUserPlots;     ///< ignore all ___sl_plot*() calls
     int errorRecoveryMode;  ///< @copydoc config.h::SE_ERROR_RECOVERY_MODE
+    int parallelRoots;      ///< count of worker processes for virtual roots
+    bool wtoScheduler;      ///< schedule blocks in weak topological order
     std::string errLabel;   ///< if not empty, treat reaching the label as error
+    std::string profile;    ///< if not empty, write a JSON profile to the file
     FixedPoint::StateByInsn *fixedPoint;  ///< fixed-point plotter (0 if unused)
 
     Options():
@@ -43,6 +46,8 @@ struct Options {
         oomSimulation(false),
         skipUserPlots(false),
         errorRecoveryMode(SE_ERROR_RECOVERY_MODE),
+        parallelRoots(0),
+        wtoScheduler(false),
         fixedPoint(0)
     {
     }
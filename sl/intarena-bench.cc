@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file intarena-bench.cc
+ * micro-benchmark replaying a trace of IntervalArena operations
+ *
+ * Build predator with IA_TRACE_OPS enabled in intarena.hh to record a trace
+ * while analyzing a test-case, then run 'intarena-bench TRACE [ROUNDS]'.  The
+ * trace is replayed on both TreeIntervalArena and FlatIntervalArena, their
+ * answers are cross-checked, and the time spent by each of them is printed.
+ */
+
+#include "intarena.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <vector>
+
+struct TraceOp {
+    char                        code;
+    long                        id;     ///< dense index of the arena
+    long                        arg0;   ///< beg, or the source arena for 'c'
+    long                        arg1;   ///< end
+    long                        fld;
+};
+
+typedef std::vector<TraceOp>                        TTrace;
+typedef std::map<long, long>                        TIdMap;
+
+/// translate an ID already allocated by the trace, return false if unknown
+bool lookupId(long *pIdx, const TIdMap &idMap, const long id)
+{
+    const TIdMap::const_iterator it = idMap.find(id);
+    if (idMap.end() == it)
+        return false;
+
+    *pIdx = it->second;
+    return true;
+}
+
+bool readTrace(TTrace *pDst, long *pCntArenas, FILE *fp)
+{
+    // map the (possibly sparse) IDs from the trace to dense indexes
+    TIdMap idMap;
+
+    char code;
+    while (1 == fscanf(fp, " %c", &code)) {
+        TraceOp op;
+        op.code = code;
+        op.arg0 = op.arg1 = op.fld = 0L;
+
+        long id;
+        bool ok;
+        switch (code) {
+            case 'n':
+            case 'd':
+            case 'x':
+                ok = (1 == fscanf(fp, "%ld", &id));
+                break;
+
+            case 'c':
+                ok = (2 == fscanf(fp, "%ld %ld", &op.arg0, &id))
+                    && lookupId(&op.arg0, idMap, op.arg0);
+                break;
+
+            case 'a':
+            case 's':
+                ok = (4 == fscanf(fp, "%ld %ld %ld %ld",
+                            &id, &op.arg0, &op.arg1, &op.fld));
+                break;
+
+            case 'i':
+            case 'e':
+                ok = (3 == fscanf(fp, "%ld %ld %ld", &id, &op.arg0, &op.arg1));
+                break;
+
+            case 'r':
+                ok = (2 == fscanf(fp, "%ld %ld", &id, &op.fld));
+                break;
+
+            default:
+                ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "error: malformed trace near op #" << pDst->size()
+                << "\n";
+            return false;
+        }
+
+        if (!lookupId(&op.id, idMap, id)) {
+            // only 'n' and 'c' may refer to an arena not seen so far
+            if ('n' != code && 'c' != code) {
+                std::cerr << "error: unknown arena " << id
+                    << " near op #" << pDst->size() << "\n";
+                return false;
+            }
+
+            op.id = idMap.size();
+            idMap[id] = op.id;
+        }
+
+        pDst->push_back(op);
+    }
+
+    *pCntArenas = idMap.size();
+    return true;
+}
+
+/// replay the trace, return a checksum of all the answers given by the arenas
+template <class TArena>
+unsigned long replayTrace(const TTrace &trace, const long cntArenas)
+{
+    typedef typename TArena::key_type                   TKey;
+    typedef typename TArena::TSet                       TSet;
+    typedef typename TArena::TKeySet                    TKeySet;
+
+    std::vector<TArena> arenas(cntArenas);
+    unsigned long sum = 0UL;
+
+    BOOST_FOREACH(const TraceOp &op, trace) {
+        TArena &arena = arenas[op.id];
+        const TKey key(op.arg0, op.arg1);
+        TSet fldSet;
+        TKeySet keySet;
+
+        switch (op.code) {
+            case 'n':
+                break;
+
+            case 'd':
+            case 'x':
+                arena.clear();
+                break;
+
+            case 'c':
+                arena = arenas[op.arg0];
+                break;
+
+            case 'a':
+                arena.add(key, op.fld);
+                break;
+
+            case 's':
+                arena.sub(key, op.fld);
+                break;
+
+            case 'i':
+                arena.intersects(fldSet, key);
+                break;
+
+            case 'e':
+                arena.exactMatch(fldSet, key);
+                break;
+
+            case 'r':
+                arena.reverseLookup(keySet, op.fld);
+                break;
+        }
+
+        // the order of the keys given by reverseLookup() is not specified
+        BOOST_FOREACH(const TKey &rKey, keySet)
+            sum += rKey.first * 31UL + rKey.second;
+
+        sum = sum * 17UL + fldSet.size();
+        BOOST_FOREACH(const long fld, fldSet)
+            sum = sum * 7UL + fld;
+    }
+
+    return sum;
+}
+
+template <class TArena>
+unsigned long runBench(
+        const char                  *name,
+        const TTrace                &trace,
+        const long                  cntArenas,
+        const int                   rounds)
+{
+    unsigned long sum = 0UL;
+    const clock_t start = clock();
+    for (int i = 0; i < rounds; ++i)
+        sum = replayTrace<TArena>(trace, cntArenas);
+
+    const float elapsed = static_cast<float>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%-24s %10.3f s (checksum %lx)\n", name, elapsed, sum);
+    return sum;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || 3 < argc) {
+        std::cerr << "usage: " << argv[0] << " TRACE [ROUNDS]\n";
+        return EXIT_FAILURE;
+    }
+
+    FILE *fp = fopen(argv[1], "r");
+    if (!fp) {
+        std::cerr << "error: failed to open " << argv[1] << "\n";
+        return EXIT_FAILURE;
+    }
+
+    TTrace trace;
+    long cntArenas;
+    const bool ok = readTrace(&trace, &cntArenas, fp);
+    fclose(fp);
+    if (!ok)
+        return EXIT_FAILURE;
+
+    const int rounds = (3 == argc) ? atoi(argv[2]) : 1;
+    printf("replaying %lu operations on %ld arenas, %d round(s)\n",
+            static_cast<unsigned long>(trace.size()), cntArenas, rounds);
+
+    const unsigned long sumTree =
+        runBench<TreeIntervalArena<long, long> >("TreeIntervalArena",
+                trace, cntArenas, rounds);
+
+    const unsigned long sumFlat =
+        runBench<FlatIntervalArena<long, long> >("FlatIntervalArena",
+                trace, cntArenas, rounds);
+
+    if (sumTree == sumFlat)
+        return EXIT_SUCCESS;
+
+    std::cerr << "error: the backends gave different answers\n";
+    return EXIT_FAILURE;
+}
@@ -21,7 +21,9 @@
 #define H_GUARD_INTARENA_H
 
 #include "config.h"
+#include "util.hh"
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <vector>
@@ -30,11 +32,29 @@
 
 #define IA_AGGRESSIVE_OPTIMIZATION          0
 
+/**
+ * if 1, IntervalArena keeps the intervals in a sorted vector (FlatIntervalArena)
+ * if 0, IntervalArena uses the original tree-based TreeIntervalArena
+ */
+#define IA_FLAT_BACKEND                     1
+
+/**
+ * if 1, write all IntervalArena operations to IA_TRACE_FILE, such a trace can
+ * be replayed by the intarena-bench program
+ */
+#define IA_TRACE_OPS                        0
+#define IA_TRACE_FILE                       "intarena.trace"
+
 /// ad-hoc implementation;  wastes memory, performance, and human resources
-template <typename TInt, typename TFld>
-class IntervalArena {
+template <typename TInt, typename TFld, class TAlloc = std::allocator<TFld> >
+class TreeIntervalArena {
+    private:
+        template <typename T> struct Alloc {
+            typedef typename TAlloc::template rebind<T>::other  Type;
+        };
+
     public:
-        typedef std::set<TFld>                      TSet;
+        typedef std::set<TFld, std::less<TFld>, TAlloc> TSet;
 
         // for compatibility with STL
         typedef std::pair<TInt, TInt>               key_type;
@@ -43,9 +63,16 @@ class IntervalArena {
         typedef std::vector<key_type>               TKeySet;
 
     private:
-        typedef std::set<TFld>                      TLeaf;
-        typedef std::map</* beg */ TInt, TLeaf>     TLine;
-        typedef std::map</* end */ TInt, TLine>     TCont;
+        typedef TSet                                TLeaf;
+
+        typedef std::map</* beg */ TInt, TLeaf, std::less<TInt>,
+                typename Alloc<std::pair<const TInt, TLeaf> >::Type>
+                                                    TLine;
+
+        typedef std::map</* end */ TInt, TLine, std::less<TInt>,
+                typename Alloc<std::pair<const TInt, TLine> >::Type>
+                                                    TCont;
+
         TCont                                       cont_;
 
     public:
@@ -60,6 +87,207 @@ class IntervalArena {
         void clear() {
             cont_.clear();
         }
+};
+
+/// the same interface as TreeIntervalArena, but stored in a single sorted vector
+template <typename TInt, typename TFld, class TAlloc = std::allocator<TFld> >
+class FlatIntervalArena {
+    public:
+        typedef std::set<TFld, std::less<TFld>, TAlloc> TSet;
+
+        // for compatibility with STL
+        typedef std::pair<TInt, TInt>               key_type;
+        typedef std::pair<key_type, TFld>           value_type;
+
+        typedef std::vector<key_type>               TKeySet;
+
+    private:
+        struct Item {
+            TInt                                    end;
+            TInt                                    beg;
+            TFld                                    fld;
+
+            Item(const TInt end_, const TInt beg_, const TFld fld_):
+                end(end_),
+                beg(beg_),
+                fld(fld_)
+            {
+            }
+
+            bool operator==(const Item &ref) const {
+                return end == ref.end
+                    && beg == ref.beg
+                    && fld == ref.fld;
+            }
+
+            bool operator<(const Item &ref) const {
+                if (end != ref.end)
+                    return end < ref.end;
+
+                if (beg != ref.beg)
+                    return beg < ref.beg;
+
+                return fld < ref.fld;
+            }
+        };
+
+        /// compare items by the upper bound of their intervals only
+        struct EndLess {
+            bool operator()(const Item &item, const TInt end) const {
+                return item.end < end;
+            }
+        };
+
+        /// compare items by their intervals only, ignoring the fields
+        struct KeyLess {
+            bool operator()(const Item &item, const key_type &key) const {
+                if (item.end != key.second)
+                    return item.end < key.second;
+
+                return item.beg < key.first;
+            }
+        };
+
+        typedef typename TAlloc::template rebind<Item>::other   TItemAlloc;
+
+        /// sorted by (end, beg, fld), no duplicates
+        typedef std::vector<Item, TItemAlloc>       TCont;
+        TCont                                       cont_;
+
+        typename TCont::iterator firstAbove(const TInt winBeg) {
+            // right-open interval given as key
+            return std::lower_bound(cont_.begin(), cont_.end(), winBeg + 1,
+                    EndLess());
+        }
+
+        typename TCont::const_iterator firstAbove(const TInt winBeg) const {
+            return std::lower_bound(cont_.begin(), cont_.end(), winBeg + 1,
+                    EndLess());
+        }
+
+    public:
+        void add(const key_type &, const TFld);
+        void sub(const key_type &, const TFld);
+        void intersects(TSet &dst, const key_type &key) const;
+        void exactMatch(TSet &dst, const key_type &key) const;
+
+        /// return the set of all keys that map to this object
+        void reverseLookup(TKeySet &dst, const TFld) const;
+
+        void clear() {
+            cont_.clear();
+        }
+};
+
+template <typename TInt, typename TFld, class TAlloc>
+struct IntervalArenaBackend {
+#if IA_FLAT_BACKEND
+    typedef FlatIntervalArena<TInt, TFld, TAlloc>   Type;
+#else
+    typedef TreeIntervalArena<TInt, TFld, TAlloc>   Type;
+#endif
+};
+
+#if IA_TRACE_OPS
+#include <cstdio>
+
+inline FILE* iaTraceStream()
+{
+    static FILE *fp = fopen(IA_TRACE_FILE, "w");
+    return fp;
+}
+
+inline long iaTraceNewId()
+{
+    static long lastId;
+    return ++lastId;
+}
+
+#   define IA_TRACE(...) do {                                               \
+        FILE *fp = iaTraceStream();                                         \
+        if (fp)                                                             \
+            fprintf(fp, __VA_ARGS__);                                       \
+    } while (0)
+#endif
+
+/// interval arena using the backend chosen by IA_FLAT_BACKEND
+template <typename TInt, typename TFld, class TAlloc = std::allocator<TFld> >
+class IntervalArena: public IntervalArenaBackend<TInt, TFld, TAlloc>::Type {
+    private:
+        typedef typename IntervalArenaBackend<TInt, TFld, TAlloc>::Type TBase;
+
+    public:
+        typedef typename TBase::TSet                TSet;
+        typedef typename TBase::key_type            key_type;
+        typedef typename TBase::value_type          value_type;
+        typedef typename TBase::TKeySet             TKeySet;
+
+#if IA_TRACE_OPS
+    private:
+        const long                                  traceId_;
+
+    public:
+        IntervalArena():
+            traceId_(iaTraceNewId())
+        {
+            IA_TRACE("n %ld\n", traceId_);
+        }
+
+        IntervalArena(const IntervalArena &ref):
+            TBase(ref),
+            traceId_(iaTraceNewId())
+        {
+            IA_TRACE("c %ld %ld\n", ref.traceId_, traceId_);
+        }
+
+        IntervalArena& operator=(const IntervalArena &ref) {
+            TBase::operator=(ref);
+            IA_TRACE("c %ld %ld\n", ref.traceId_, traceId_);
+            return *this;
+        }
+
+        ~IntervalArena() {
+            IA_TRACE("d %ld\n", traceId_);
+        }
+
+        void add(const key_type &key, const TFld fld) {
+            IA_TRACE("a %ld %ld %ld %ld\n", traceId_, static_cast<long>(
+                        key.first), static_cast<long>(key.second),
+                    static_cast<long>(fld));
+            TBase::add(key, fld);
+        }
+
+        void sub(const key_type &key, const TFld fld) {
+            IA_TRACE("s %ld %ld %ld %ld\n", traceId_, static_cast<long>(
+                        key.first), static_cast<long>(key.second),
+                    static_cast<long>(fld));
+            TBase::sub(key, fld);
+        }
+
+        void intersects(TSet &dst, const key_type &key) const {
+            IA_TRACE("i %ld %ld %ld\n", traceId_,
+                    static_cast<long>(key.first),
+                    static_cast<long>(key.second));
+            TBase::intersects(dst, key);
+        }
+
+        void exactMatch(TSet &dst, const key_type &key) const {
+            IA_TRACE("e %ld %ld %ld\n", traceId_,
+                    static_cast<long>(key.first),
+                    static_cast<long>(key.second));
+            TBase::exactMatch(dst, key);
+        }
+
+        void reverseLookup(TKeySet &dst, const TFld fld) const {
+            IA_TRACE("r %ld %ld\n", traceId_, static_cast<long>(fld));
+            TBase::reverseLookup(dst, fld);
+        }
+
+        void clear() {
+            IA_TRACE("x %ld\n", traceId_);
+            TBase::clear();
+        }
+#endif // IA_TRACE_OPS
 
         IntervalArena& operator+=(const value_type &item) {
             this->add(item.first, item.second);
@@ -72,8 +300,11 @@ class IntervalArena {
         }
 };
 
-template <typename TInt, typename TFld>
-void IntervalArena<TInt, TFld>::add(const key_type &key, const TFld fld)
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of TreeIntervalArena
+template <typename TInt, typename TFld, class TAlloc>
+void TreeIntervalArena<TInt, TFld, TAlloc>::add(const key_type &key, const TFld fld)
 {
     const TInt beg = key.first;
     const TInt end = key.second;
@@ -82,8 +313,8 @@ void IntervalArena<TInt, TFld>::add(const key_type &key, const TFld fld)
     cont_[end][beg].insert(fld);
 }
 
-template <typename TInt, typename TFld>
-void IntervalArena<TInt, TFld>::sub(const key_type &key, const TFld fld)
+template <typename TInt, typename TFld, class TAlloc>
+void TreeIntervalArena<TInt, TFld, TAlloc>::sub(const key_type &key, const TFld fld)
 {
     const TInt winBeg = key.first;
     const TInt winEnd = key.second;
@@ -181,8 +412,8 @@ void IntervalArena<TInt, TFld>::sub(const key_type &key, const TFld fld)
     }
 }
 
-template <typename TInt, typename TFld>
-void IntervalArena<TInt, TFld>::intersects(TSet &dst, const key_type &key) const
+template <typename TInt, typename TFld, class TAlloc>
+void TreeIntervalArena<TInt, TFld, TAlloc>::intersects(TSet &dst, const key_type &key) const
 {
     const TInt winBeg = key.first;
     const TInt winEnd = key.second;
@@ -226,8 +457,8 @@ void IntervalArena<TInt, TFld>::intersects(TSet &dst, const key_type &key) const
 
 // FIXME: brute-force method
 // FIXME: no assumptions can be made about the output format
-template <typename TInt, typename TFld>
-void IntervalArena<TInt, TFld>::reverseLookup(TKeySet &dst, const TFld fld)
+template <typename TInt, typename TFld, class TAlloc>
+void TreeIntervalArena<TInt, TFld, TAlloc>::reverseLookup(TKeySet &dst, const TFld fld)
     const
 {
     key_type key;
@@ -247,8 +478,8 @@ void IntervalArena<TInt, TFld>::reverseLookup(TKeySet &dst, const TFld fld)
     }
 }
 
-template <typename TInt, typename TFld>
-void IntervalArena<TInt, TFld>::exactMatch(TSet &dst, const key_type &key) const
+template <typename TInt, typename TFld, class TAlloc>
+void TreeIntervalArena<TInt, TFld, TAlloc>::exactMatch(TSet &dst, const key_type &key) const
 {
     typedef typename TCont::const_iterator TEndIt;
     const TEndIt itEnd = cont_.find(/* end */ key.second);
@@ -266,4 +497,111 @@ void IntervalArena<TInt, TFld>::exactMatch(TSet &dst, const key_type &key) const
     std::copy(leaf.begin(), leaf.end(), std::inserter(dst, dst.begin()));
 }
 
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of FlatIntervalArena
+template <typename TInt, typename TFld, class TAlloc>
+void FlatIntervalArena<TInt, TFld, TAlloc>::add(const key_type &key, const TFld fld)
+{
+    const TInt beg = key.first;
+    const TInt end = key.second;
+    CL_BREAK_IF(end <= beg);
+
+    const Item item(end, beg, fld);
+    const typename TCont::iterator it =
+        std::lower_bound(cont_.begin(), cont_.end(), item);
+
+    if (cont_.end() == it || !(*it == item))
+        cont_.insert(it, item);
+}
+
+template <typename TInt, typename TFld, class TAlloc>
+void FlatIntervalArena<TInt, TFld, TAlloc>::sub(const key_type &key, const TFld fld)
+{
+    const TInt winBeg = key.first;
+    const TInt winEnd = key.second;
+    CL_BREAK_IF(winEnd <= winBeg);
+
+    std::vector<value_type> recoverList;
+
+    // remove the matching items, compacting the rest of the vector in place
+    const typename TCont::iterator itEnd = cont_.end();
+    typename TCont::iterator dst = this->firstAbove(winBeg);
+    for (typename TCont::iterator src = dst; itEnd != src; ++src) {
+        const Item &item = *src;
+        if (item.fld == fld && item.beg < winEnd) {
+            if (item.beg < winBeg) {
+                // schedule "the part above" for re-insertion
+                const key_type key(item.beg, winBeg);
+                recoverList.push_back(value_type(key, fld));
+            }
+
+            if (winEnd < item.end) {
+                // schedule "the part beyond" for re-insertion
+                const key_type key(winEnd, item.end);
+                recoverList.push_back(value_type(key, fld));
+            }
+
+            continue;
+        }
+
+        if (dst != src)
+            *dst = item;
+
+        ++dst;
+    }
+
+    cont_.erase(dst, itEnd);
+
+    // go through the recoverList and re-insert the missing parts
+    BOOST_FOREACH(const value_type &rItem, recoverList)
+        this->add(rItem.first, rItem.second);
+}
+
+template <typename TInt, typename TFld, class TAlloc>
+void FlatIntervalArena<TInt, TFld, TAlloc>::intersects(TSet &dst, const key_type &key) const
+{
+    const TInt winBeg = key.first;
+    const TInt winEnd = key.second;
+    CL_BREAK_IF(winEnd <= winBeg);
+
+    const typename TCont::const_iterator itEnd = cont_.end();
+    for (typename TCont::const_iterator it = this->firstAbove(winBeg);
+            itEnd != it; ++it)
+    {
+        // make sure the basic window axiom holds
+        CL_BREAK_IF(it->end <= winBeg);
+
+        if (it->beg < winEnd)
+            dst.insert(it->fld);
+    }
+}
+
+// FIXME: brute-force method
+// FIXME: no assumptions can be made about the output format
+template <typename TInt, typename TFld, class TAlloc>
+void FlatIntervalArena<TInt, TFld, TAlloc>::reverseLookup(TKeySet &dst, const TFld fld)
+    const
+{
+    BOOST_FOREACH(const Item &item, cont_)
+        if (item.fld == fld)
+            dst.push_back(key_type(item.beg, item.end));
+}
+
+template <typename TInt, typename TFld, class TAlloc>
+void FlatIntervalArena<TInt, TFld, TAlloc>::exactMatch(TSet &dst, const key_type &key) const
+{
+    const typename TCont::const_iterator itEnd = cont_.end();
+    typename TCont::const_iterator it =
+        std::lower_bound(cont_.begin(), itEnd, key, KeyLess());
+
+    for (; itEnd != it; ++it) {
+        if (it->end != key.second || it->beg != key.first)
+            // no more items with the same key
+            break;
+
+        dst.insert(dst.end(), it->fld);
+    }
+}
+
 #endif /* H_GUARD_INTARENA_H */
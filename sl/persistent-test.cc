@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file persistent-test.cc
+ * differential test of PersistentSet and PersistentMap against std::set/map
+ *
+ * Random inserts, erases and writes through operator[] are applied to both the
+ * persistent containers and their STL counterparts.  Copies of the containers
+ * are taken between the operations and checked to stay unchanged while the
+ * original (or another copy) is being modified.  Run 'persistent-test [SEED]',
+ * the exit code is non-zero if any difference is found.
+ */
+
+#include "persistent.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <set>
+#include <vector>
+
+typedef PersistentSet<int>                          TPSet;
+typedef PersistentMap<int, int>                     TPMap;
+typedef std::set<int>                               TSet;
+typedef std::map<int, int>                          TMap;
+
+/// a persistent container together with the STL container it should equal
+template <class TPersType, class TStlType>
+struct Twin {
+    typedef TPersType           TPers;
+    typedef TStlType            TStl;
+
+    TPers                       pers;
+    TStl                        stl;
+};
+
+typedef Twin<TPSet, TSet>                           TSetTwin;
+typedef Twin<TPMap, TMap>                           TMapTwin;
+
+static int cntErrors;
+
+#define CHECK(cond, what) do {                                              \
+    if (!(cond)) {                                                          \
+        fprintf(stderr, "%s:%d: %s (step %ld)\n",                           \
+                __FILE__, __LINE__, what, step);                            \
+        ++cntErrors;                                                        \
+    }                                                                       \
+} while (0)
+
+bool sameItem(const int a, const int b)
+{
+    return (a == b);
+}
+
+bool sameItem(
+        const std::pair<const int, int>    &a,
+        const std::pair<const int, int>    &b)
+{
+    return (a.first == b.first)
+        && (a.second == b.second);
+}
+
+int keyOf(const int key)
+{
+    return key;
+}
+
+int keyOf(const std::pair<const int, int> &item)
+{
+    return item.first;
+}
+
+/// compare the contents in order, then look up each key, then a missing one
+template <class TPers, class TStl>
+void checkEqual(const TPers &pers, const TStl &stl, const long step)
+{
+    CHECK(pers.size() == stl.size(), "size mismatch");
+    CHECK(pers.empty() == stl.empty(), "empty() mismatch");
+
+    typename TPers::const_iterator pi = pers.begin();
+    typename TStl::const_iterator si = stl.begin();
+    for (; pers.end() != pi && stl.end() != si; ++pi, ++si)
+        CHECK(sameItem(*pi, *si), "item mismatch while iterating");
+
+    CHECK(pers.end() == pi, "extra items in the persistent container");
+    CHECK(stl.end() == si, "missing items in the persistent container");
+
+    for (si = stl.begin(); stl.end() != si; ++si) {
+        const int key = keyOf(*si);
+        pi = pers.find(key);
+        CHECK(pers.end() != pi && sameItem(*pi, *si), "find() mismatch");
+        CHECK(1U == pers.count(key), "count() mismatch");
+    }
+
+    // keys are drawn from [0, range), so this one is never present
+    CHECK(pers.end() == pers.find(-1), "find() of a missing key");
+    CHECK(!pers.count(-1), "count() of a missing key");
+}
+
+template <class TTwin>
+void checkAll(const std::vector<TTwin> &twins, const long step)
+{
+    for (unsigned i = 0; i < twins.size(); ++i)
+        checkEqual(twins[i].pers, twins[i].stl, step);
+}
+
+void stepSet(std::vector<TSetTwin> &twins, const int range, const long step)
+{
+    TSetTwin &twin = twins[rand() % twins.size()];
+    const int key = rand() % range;
+
+    switch (rand() % 4) {
+        case 0:
+        case 1: {
+            const bool inserted = twin.pers.insert(key).second;
+            CHECK(inserted == twin.stl.insert(key).second, "insert() result");
+            break;
+        }
+
+        case 2:
+            CHECK(twin.pers.erase(key) == twin.stl.erase(key), "erase() result");
+            break;
+
+        case 3:
+            // take a copy which has to survive the changes of the original
+            twins.push_back(twin);
+            break;
+    }
+}
+
+void stepMap(std::vector<TMapTwin> &twins, const int range, const long step)
+{
+    TMapTwin &twin = twins[rand() % twins.size()];
+    const int key = rand() % range;
+    const int val = rand();
+
+    switch (rand() % 5) {
+        case 0: {
+            const TMap::value_type item(key, val);
+            const bool inserted = twin.pers.insert(item).second;
+            CHECK(inserted == twin.stl.insert(item).second, "insert() result");
+            break;
+        }
+
+        case 1:
+            twin.pers[key] = val;
+            twin.stl[key] = val;
+            break;
+
+        case 2:
+            CHECK(twin.pers[key] == twin.stl[key], "operator[] result");
+            break;
+
+        case 3:
+            CHECK(twin.pers.erase(key) == twin.stl.erase(key), "erase() result");
+            break;
+
+        case 4:
+            // take a copy which has to survive the changes of the original
+            twins.push_back(twin);
+            break;
+    }
+}
+
+/// run one round of random operations, on at most cntTwins containers
+template <class TTwin>
+void runRound(
+        void                  (*stepFnc)(std::vector<TTwin> &, int, long),
+        const int               range,
+        const unsigned          cntTwins,
+        const long              cntSteps)
+{
+    std::vector<TTwin> twins(1);
+    for (long step = 0; step < cntSteps; ++step) {
+        // replace a random copy by a fresh one when there are enough of them
+        if (cntTwins < twins.size())
+            twins.erase(twins.begin() + rand() % twins.size());
+
+        stepFnc(twins, range, step);
+
+        if (!(step % 64))
+            checkAll(twins, step);
+    }
+
+    checkAll(twins, cntSteps);
+
+    // drain the containers one by one, the others need to stay unchanged
+    for (long step = cntSteps; !twins.empty(); ++step) {
+        TTwin &twin = twins.back();
+        if (twin.stl.empty()) {
+            twins.pop_back();
+            checkAll(twins, step);
+            continue;
+        }
+
+        // erase a random key to exercise removal of inner nodes, too
+        typename TTwin::TStl::const_iterator it = twin.stl.begin();
+        std::advance(it, rand() % twin.stl.size());
+        const int key = keyOf(*it);
+        twin.stl.erase(key);
+        CHECK(1U == twin.pers.erase(key), "erase() while draining");
+
+        if (!(step % 64))
+            checkAll(twins, step);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const unsigned seed = (1 < argc) ? atoi(argv[1]) : 1U;
+    srand(seed);
+
+    // small ranges exercise erase of existing keys, big ones deep trees
+    const int ranges[] = { 4, 32, 256, 4096 };
+    for (unsigned i = 0; i < sizeof ranges / sizeof ranges[0]; ++i) {
+        runRound<TSetTwin>(stepSet, ranges[i], /* cntTwins */ 8, 20000L);
+        runRound<TMapTwin>(stepMap, ranges[i], /* cntTwins */ 8, 20000L);
+    }
+
+    if (cntErrors) {
+        fprintf(stderr, "persistent-test: %d error(s), seed %u\n",
+                cntErrors, seed);
+        return EXIT_FAILURE;
+    }
+
+    printf("persistent-test: OK, seed %u\n", seed);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,469 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef H_GUARD_PERSISTENT_H
+#define H_GUARD_PERSISTENT_H
+
+#include "config.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+/**
+ * @file persistent.hh
+ * persistent (structurally shared) replacements of std::set and std::map
+ *
+ * Copy of a container takes O(1) time.  The containers are AVL trees with
+ * reference-counted nodes.  Whenever a node is about to be changed while it
+ * is shared with another container, it is copied first (path copying).  So a
+ * single insert or erase after copying a container copies only O(log n)
+ * nodes, instead of the whole container.  Only a subset of the STL interface
+ * is implemented and the iterators are read-only.
+ */
+
+template <class TKey, class TValue, class TKeyOf, class TCmp>
+class PersistentTree {
+    private:
+        struct Node {
+            int                         refCnt;
+            int                         height;
+            Node                       *left;
+            Node                       *right;
+            TValue                      value;
+
+            Node(const TValue &value_, Node *left_, Node *right_, int height_):
+                refCnt(1),
+                height(height_),
+                left(left_),
+                right(right_),
+                value(value_)
+            {
+            }
+        };
+
+    public:
+        /// in-order iterator, keeps the stack of pending ancestors
+        class const_iterator {
+            public:
+                // for compatibility with STL and Boost libraries
+                typedef std::forward_iterator_tag       iterator_category;
+                typedef TValue                          value_type;
+                typedef ptrdiff_t                       difference_type;
+                typedef const TValue                   *pointer;
+                typedef const TValue                   &reference;
+
+                const_iterator():
+                    depth_(0)
+                {
+                }
+
+                reference operator*() const {
+                    CL_BREAK_IF(!depth_);
+                    return stack_[depth_ - 1]->value;
+                }
+
+                pointer operator->() const {
+                    return &this->operator*();
+                }
+
+                const_iterator& operator++() {
+                    CL_BREAK_IF(!depth_);
+                    const Node *node = stack_[--depth_];
+                    this->pushLeftPath(node->right);
+                    return *this;
+                }
+
+                const_iterator operator++(int) {
+                    const const_iterator old(*this);
+                    ++(*this);
+                    return old;
+                }
+
+                bool operator==(const const_iterator &ref) const {
+                    if (depth_ != ref.depth_)
+                        return false;
+
+                    return !depth_
+                        || stack_[depth_ - 1] == ref.stack_[depth_ - 1];
+                }
+
+                bool operator!=(const const_iterator &ref) const {
+                    return !this->operator==(ref);
+                }
+
+            private:
+                friend class PersistentTree;
+
+                // an AVL tree of this height would need more than 2^32 nodes
+                enum { MAX_DEPTH = 48 };
+
+                const Node             *stack_[MAX_DEPTH];
+                int                     depth_;
+
+                void push(const Node *node) {
+                    CL_BREAK_IF(MAX_DEPTH <= depth_);
+                    stack_[depth_++] = node;
+                }
+
+                void pushLeftPath(const Node *node) {
+                    for (; node; node = node->left)
+                        this->push(node);
+                }
+        };
+
+        // for compatibility with STL and Boost libraries
+        typedef TKey                                    key_type;
+        typedef TValue                                  value_type;
+        typedef const TValue                           &const_reference;
+        typedef size_t                                  size_type;
+        typedef const_iterator                          iterator;
+
+    public:
+        PersistentTree():
+            root_(0),
+            size_(0)
+        {
+        }
+
+        PersistentTree(const PersistentTree &ref):
+            root_(share(ref.root_)),
+            size_(ref.size_)
+        {
+        }
+
+        PersistentTree& operator=(const PersistentTree &ref) {
+            Node *root = share(ref.root_);
+            release(root_);
+            root_ = root;
+            size_ = ref.size_;
+            return *this;
+        }
+
+        ~PersistentTree() {
+            release(root_);
+        }
+
+        void swap(PersistentTree &ref) {
+            std::swap(root_, ref.root_);
+            std::swap(size_, ref.size_);
+        }
+
+        bool empty() const {
+            return !size_;
+        }
+
+        size_type size() const {
+            return size_;
+        }
+
+        void clear() {
+            release(root_);
+            root_ = 0;
+            size_ = 0;
+        }
+
+        const_iterator begin() const {
+            const_iterator it;
+            it.pushLeftPath(root_);
+            return it;
+        }
+
+        const_iterator end() const {
+            return const_iterator();
+        }
+
+        const_iterator find(const TKey &key) const {
+            const_iterator it;
+            const Node *node = root_;
+            while (node) {
+                const TKey &nodeKey = TKeyOf::get(node->value);
+                if (cmp_(key, nodeKey)) {
+                    // the node is still pending in the in-order traversal
+                    it.push(node);
+                    node = node->left;
+                }
+                else if (cmp_(nodeKey, key))
+                    node = node->right;
+                else {
+                    it.push(node);
+                    return it;
+                }
+            }
+
+            return this->end();
+        }
+
+        size_type count(const TKey &key) const {
+            return (this->end() != this->find(key));
+        }
+
+        size_type erase(const TKey &key) {
+            if (!this->count(key))
+                // nothing to erase, avoid copying the path
+                return 0;
+
+            eraseAt(root_, key);
+            --size_;
+            return 1;
+        }
+
+    protected:
+        /// insert the value unless its key is present already
+        /// @return pointer to the value stored for the key, writable in place
+        TValue* insertUnique(const TValue &value, bool *pInserted) {
+            *pInserted = false;
+            TValue *pValue = this->insertAt(root_, value, pInserted);
+            if (*pInserted)
+                ++size_;
+
+            return pValue;
+        }
+
+    private:
+        Node                           *root_;
+        size_type                       size_;
+        TCmp                            cmp_;
+
+        static Node* share(Node *node) {
+            if (node)
+                ++node->refCnt;
+
+            return node;
+        }
+
+        static void release(Node *node) {
+            while (node && !--node->refCnt) {
+                release(node->left);
+                Node *right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+
+        /// make sure we can change the node without affecting other containers
+        static void makeUnique(Node *&node) {
+            if (1 == node->refCnt)
+                return;
+
+            Node *dup = new Node(node->value, share(node->left),
+                    share(node->right), node->height);
+
+            // somebody else still holds the original node
+            --node->refCnt;
+            node = dup;
+        }
+
+        static int heightOf(const Node *node) {
+            return (node) ? node->height : 0;
+        }
+
+        static void updateHeight(Node *node) {
+            node->height = 1 + std::max(heightOf(node->left),
+                    heightOf(node->right));
+        }
+
+        static void rotateLeft(Node *&node) {
+            makeUnique(node->right);
+            Node *pivot = node->right;
+            node->right = pivot->left;
+            pivot->left = node;
+            updateHeight(node);
+            updateHeight(pivot);
+            node = pivot;
+        }
+
+        static void rotateRight(Node *&node) {
+            makeUnique(node->left);
+            Node *pivot = node->left;
+            node->left = pivot->right;
+            pivot->right = node;
+            updateHeight(node);
+            updateHeight(pivot);
+            node = pivot;
+        }
+
+        /// the node needs to be unique already
+        static void rebalance(Node *&node) {
+            updateHeight(node);
+            const int balance = heightOf(node->left) - heightOf(node->right);
+            if (1 < balance) {
+                if (heightOf(node->left->left) < heightOf(node->left->right)) {
+                    makeUnique(node->left);
+                    rotateLeft(node->left);
+                }
+
+                rotateRight(node);
+            }
+            else if (balance < -1) {
+                if (heightOf(node->right->right) < heightOf(node->right->left)) {
+                    makeUnique(node->right);
+                    rotateRight(node->right);
+                }
+
+                rotateLeft(node);
+            }
+        }
+
+        TValue* insertAt(Node *&node, const TValue &value, bool *pInserted) {
+            if (!node) {
+                node = new Node(value, 0, 0, /* height */ 1);
+                *pInserted = true;
+                return &node->value;
+            }
+
+            makeUnique(node);
+            const TKey &key = TKeyOf::get(value);
+            const TKey &nodeKey = TKeyOf::get(node->value);
+
+            // rotations below never copy the nodes on the path we went through
+            TValue *pValue;
+            if (cmp_(key, nodeKey))
+                pValue = this->insertAt(node->left, value, pInserted);
+            else if (cmp_(nodeKey, key))
+                pValue = this->insertAt(node->right, value, pInserted);
+            else
+                return &node->value;
+
+            if (*pInserted)
+                rebalance(node);
+
+            return pValue;
+        }
+
+        /// detach the leftmost node of the subtree, which needs to be non-empty
+        static Node* detachMin(Node *&node) {
+            makeUnique(node);
+            if (!node->left) {
+                Node *min = node;
+                node = min->right;
+                min->right = 0;
+                return min;
+            }
+
+            Node *min = detachMin(node->left);
+            rebalance(node);
+            return min;
+        }
+
+        void eraseAt(Node *&node, const TKey &key) {
+            CL_BREAK_IF(!node);
+            makeUnique(node);
+            const TKey &nodeKey = TKeyOf::get(node->value);
+            if (cmp_(key, nodeKey))
+                this->eraseAt(node->left, key);
+            else if (cmp_(nodeKey, key))
+                this->eraseAt(node->right, key);
+            else {
+                Node *victim = node;
+                if (victim->right) {
+                    // replace the victim by its in-order successor
+                    Node *succ = detachMin(victim->right);
+                    succ->left = victim->left;
+                    succ->right = victim->right;
+                    node = succ;
+                }
+                else {
+                    // the left subtree is balanced already
+                    node = victim->left;
+                    victim->left = 0;
+                    release(victim);
+                    return;
+                }
+
+                victim->left = 0;
+                victim->right = 0;
+                release(victim);
+            }
+
+            rebalance(node);
+        }
+};
+
+template <class TKey>
+struct PersistentSetKeyOf {
+    static const TKey& get(const TKey &key) {
+        return key;
+    }
+};
+
+template <class TKey, class TVal>
+struct PersistentMapKeyOf {
+    static const TKey& get(const std::pair<const TKey, TVal> &item) {
+        return item.first;
+    }
+};
+
+/// persistent replacement of std::set
+template <class TKey, class TCmp = std::less<TKey> >
+class PersistentSet:
+    public PersistentTree<TKey, TKey, PersistentSetKeyOf<TKey>, TCmp>
+{
+    private:
+        typedef PersistentTree<TKey, TKey, PersistentSetKeyOf<TKey>, TCmp>
+                                                        TBase;
+
+    public:
+        typedef typename TBase::const_iterator          const_iterator;
+
+        std::pair<const_iterator, bool> insert(const TKey &key) {
+            bool inserted = false;
+            if (!this->count(key))
+                this->insertUnique(key, &inserted);
+
+            return std::make_pair(this->find(key), inserted);
+        }
+};
+
+/// persistent replacement of std::map
+template <class TKey, class TVal, class TCmp = std::less<TKey> >
+class PersistentMap:
+    public PersistentTree<TKey, std::pair<const TKey, TVal>,
+                          PersistentMapKeyOf<TKey, TVal>, TCmp>
+{
+    private:
+        typedef PersistentTree<TKey, std::pair<const TKey, TVal>,
+                               PersistentMapKeyOf<TKey, TVal>, TCmp>
+                                                        TBase;
+
+    public:
+        typedef typename TBase::const_iterator          const_iterator;
+        typedef typename TBase::value_type              value_type;
+        typedef TVal                                    mapped_type;
+
+        std::pair<const_iterator, bool> insert(const value_type &item) {
+            bool inserted = false;
+            if (!this->count(item.first))
+                this->insertUnique(item, &inserted);
+
+            return std::make_pair(this->find(item.first), inserted);
+        }
+
+        /// the returned reference is valid until the next change of the map
+        TVal& operator[](const TKey &key) {
+            bool inserted;
+            return this->insertUnique(value_type(key, TVal()), &inserted)
+                ->second;
+        }
+};
+
+#endif /* H_GUARD_PERSISTENT_H */
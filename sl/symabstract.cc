@@ -31,6 +31,7 @@
 #include "symjoin.hh"
 #include "symdiscover.hh"
 #include "symgc.hh"
+#include "symprof.hh"
 #include "symseg.hh"
 #include "symutil.hh"
 #include "symtrace.hh"
@@ -331,6 +332,7 @@ bool applyAbstraction(
         // abstraction step has succeeded, update the trace graph!
         trAbs->setPlotName(pName);
         sh.traceUpdate(trAbs);
+        Profile::count(Profile::PC_ABSTRACT_STEPS);
 
         CL_BREAK_IF(!protoCheckConsistency(sh));
     }
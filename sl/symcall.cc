@@ -43,12 +43,28 @@
 
 LOCAL_DEBUG_PLOTTER(symcall, DEBUG_SYMCALL)
 
+// /////////////////////////////////////////////////////////////////////////////
+// call cache statistics per one fnc
+struct PerFncCacheStats {
+    unsigned        cntHits;
+    unsigned        cntMisses;
+    unsigned        cntProbes;      ///< count of cache entries compared
+
+    PerFncCacheStats():
+        cntHits(0U),
+        cntMisses(0U),
+        cntProbes(0U)
+    {
+    }
+};
+
 // /////////////////////////////////////////////////////////////////////////////
 // call context cache per one fnc
 class PerFncCache {
     private:
         typedef std::vector<SymCallCtx *> TCtxMap;
 
+        /// cut entry heaps, indexed by heapFingerprint() for O(1) lookup
         SymHeapUnion    huni_;
         TCtxMap         ctxMap_;
 #if !SE_ENABLE_CALL_CACHE
@@ -56,7 +72,7 @@ class PerFncCache {
 #endif
         int             missCntSinceLastHit_;
 
-        int lookupCore(const SymHeap &sh);
+        int lookupCore(const SymHeap &sh, PerFncCacheStats *stats = 0);
 
         void cacheHit() {
             if (0 < missCntSinceLastHit_)
@@ -105,18 +121,37 @@ class PerFncCache {
          * look for the given heap; return the corresponding call ctx if found,
          * 0 otherwise
          */
-        SymCallCtx*& lookup(const SymHeap &sh) {
+        SymCallCtx*& lookup(const SymHeap &sh, PerFncCacheStats &stats) {
 #if SE_ENABLE_CALL_CACHE
-            return ctxMap_[this->lookupCore(sh)];
+            return ctxMap_[this->lookupCore(sh, &stats)];
 #else
             (void) sh;
+            ++stats.cntMisses;
             return null_ = 0;
 #endif
         }
 };
 
-int PerFncCache::lookupCore(const SymHeap &sh)
+int PerFncCache::lookupCore(const SymHeap &sh, PerFncCacheStats *stats)
 {
+    // look for an isomorphic entry first, guided by the fingerprint index
+    unsigned cntProbes = 0U;
+    int idx = huni_.lookup(sh, &cntProbes);
+    if (stats)
+        stats->cntProbes += cntProbes;
+
+    if (-1 != idx) {
+        this->cacheHit();
+        if (stats)
+            ++stats->cntHits;
+#if 1 < SE_STATE_ON_THE_FLY_ORDERING
+        rotate(ctxMap_.begin(), ctxMap_.begin() + idx, ctxMap_.end());
+        return 0;
+#else
+        return idx;
+#endif
+    }
+
 #if 1 < SE_ENABLE_CALL_CACHE
 #if SE_STATE_ON_THE_FLY_ORDERING
 #error "SE_STATE_ON_THE_FLY_ORDERING is incompatible with join-based call cache"
@@ -124,11 +159,13 @@ int PerFncCache::lookupCore(const SymHeap &sh)
     EJoinStatus     status;
     SymHeap         result(sh.stor(), new Trace::TransientNode("PerFncCache"));
     const int       cnt = huni_.size();
-    int             idx;
 
-    // try join
+    // no isomorphic entry, try join
     for(idx = 0; idx < cnt; ++idx) {
         const SymHeap &shIn = huni_[idx];
+        if (stats)
+            ++stats->cntProbes;
+
         if (!joinSymHeaps(&status, &result, shIn, sh))
             // join failed with this heap, try the next one
             continue;
@@ -138,6 +175,8 @@ int PerFncCache::lookupCore(const SymHeap &sh)
             case JS_USE_SH1:
                 // already covered by the cached ctx --> cache hit!
                 this->cacheHit();
+                if (stats)
+                    ++stats->cntHits;
                 return idx;
 
             case JS_USE_SH2:
@@ -166,20 +205,10 @@ int PerFncCache::lookupCore(const SymHeap &sh)
         }
 
         this->cacheHit();
+        if (stats)
+            ++stats->cntHits;
         return idx;
     }
-
-#else // 1 == SE_ENABLE_CALL_CACHE means "graph isomorphism only"
-    int idx = huni_.lookup(sh);
-    if (-1 != idx) {
-        this->cacheHit();
-#   if 1 < SE_STATE_ON_THE_FLY_ORDERING
-        rotate(ctxMap_.begin(), ctxMap_.begin() + idx, ctxMap_.end());
-        return 0;
-#   else
-        return idx;
-#   endif
-    }
 #endif
 
     // cache miss
@@ -189,6 +218,8 @@ int PerFncCache::lookupCore(const SymHeap &sh)
     CL_BREAK_IF(huni_.size() != ctxMap_.size());
 
     ++missCntSinceLastHit_;
+    if (stats)
+        ++stats->cntMisses;
     return idx;
 }
 
@@ -199,9 +230,11 @@ struct SymCallCache::Private {
     typedef const CodeStorage::Fnc                     &TFncRef;
     typedef CodeStorage::TVarSet                        TFncVarSet;
     typedef std::map<int /* uid */, PerFncCache>        TCache;
+    typedef std::map<int /* uid */, PerFncCacheStats>   TStats;
     typedef std::vector<SymCallCtx *>                   TCtxStack;
 
     TCache                      cache;
+    TStats                      stats;
     TCtxStack                   ctxStack;
     SymBackTrace                bt;
 
@@ -511,6 +544,26 @@ SymBackTrace& SymCallCache::bt()
     return d->bt;
 }
 
+void SymCallCache::printStats() const
+{
+    TStorRef stor = d->bt.stor();
+
+    BOOST_FOREACH(Private::TStats::const_reference item, d->stats) {
+        const CodeStorage::Fnc &fnc = *stor.fncs[/* uid */ item.first];
+        const PerFncCacheStats &stats = item.second;
+
+        const unsigned cntLookups = stats.cntHits + stats.cntMisses;
+        const float avgProbes = (cntLookups)
+            ? static_cast<float>(stats.cntProbes) / cntLookups
+            : 0.0;
+
+        CL_DEBUG_MSG(locationOf(fnc), "SymCallCache: " << nameOf(fnc) << "()"
+                << ": " << stats.cntHits << " hit(s)"
+                << ", " << stats.cntMisses << " miss(es)"
+                << ", " << avgProbes << " probe(s) per lookup");
+    }
+}
+
 void pullGlVar(SymHeap &result, SymHeap origin, const CVar &cv)
 {
     // do not try to combine things, it causes problems
@@ -715,7 +768,7 @@ SymCallCtx* SymCallCache::Private::getCallCtx(const SymHeap &entry, TFncRef fnc)
     // cache lookup
     const int uid = uidOf(fnc);
     PerFncCache &pfc = this->cache[uid];
-    SymCallCtx *&ctx = pfc.lookup(entry);
+    SymCallCtx *&ctx = pfc.lookup(entry, this->stats[uid]);
     if (!ctx) {
         // cache miss
         ctx = new SymCallCtx(this);
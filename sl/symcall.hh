@@ -61,6 +61,9 @@ class SymCallCache {
                 const CodeStorage::Fnc       &fnc,
                 const CodeStorage::Insn      &insn);
 
+        /// print hit/miss/probe-length statistics per each called function
+        void printStats() const;
+
     private:
         /// object copying is @b not allowed
         SymCallCache(const SymCallCache &);
@@ -22,12 +22,14 @@
 
 #include <cl/cl_msg.hh>
 
+#include "symprof.hh"
 #include "symseg.hh"
 #include "symutil.hh"
 #include "util.hh"
 #include "worklist.hh"
 
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/tuple/tuple.hpp>
 
 bool matchOffsets(
@@ -316,6 +318,8 @@ bool areEqual(
         const SymHeap           &sh1,
         const SymHeap           &sh2)
 {
+    Profile::count(Profile::PC_ARE_EQUAL);
+
     SymHeap &sh1Writable = const_cast<SymHeap &>(sh1);
     SymHeap &sh2Writable = const_cast<SymHeap &>(sh2);
 
@@ -346,3 +350,93 @@ bool areEqual(
     return sh1.matchPreds(sh2, vMap[0])
         && sh2.matchPreds(sh1, vMap[1]);
 }
+
+typedef std::map<TObjId, int /* canonical ID */>    TCanonMap;
+typedef std::queue<TObjId>                          TFpSched;
+typedef WorkList<TObjId, TFpSched>                  TFpWorkList;
+
+class FingerprintVisitor {
+    private:
+        TFpWorkList         &wl_;
+        TCanonMap           &canon_;
+        THeapFingerprint    &fp_;
+        SymHeap             &sh_;
+
+    public:
+        FingerprintVisitor(
+                TFpWorkList         &wl,
+                TCanonMap           &canon,
+                THeapFingerprint    &fp,
+                SymHeap             &sh):
+            wl_(wl),
+            canon_(canon),
+            fp_(fp),
+            sh_(sh)
+        {
+        }
+
+        bool operator()(FldHandle item[1]) {
+            const FldHandle &fld = item[0];
+            const TValId val = fld.value();
+            if (val <= 0 || !isPossibleToDeref(sh_, val))
+                // hash only the pointer structure, the rest is matched lazily
+                return /* continue */ true;
+
+            boost::hash_combine(fp_, fld.offset());
+            boost::hash_combine(fp_, sh_.valOffset(val));
+            boost::hash_combine(fp_, static_cast<int>(sh_.targetSpec(val)));
+
+            // assign canonical IDs in the order the objects are scheduled
+            const TObjId obj = sh_.objByAddr(val);
+            if (wl_.schedule(obj)) {
+                const int id = canon_.size();
+                canon_[obj] = id;
+
+                // hash the properties checked by matchRoots()
+                const TSizeRange size = sh_.objSize(obj);
+                boost::hash_combine(fp_, size.lo);
+                boost::hash_combine(fp_, size.hi);
+                boost::hash_combine(fp_, sh_.objProtoLevel(obj));
+
+                const EObjKind kind = sh_.objKind(obj);
+                boost::hash_combine(fp_, static_cast<int>(kind));
+                if (OK_REGION != kind)
+                    boost::hash_combine(fp_, sh_.segMinLength(obj));
+            }
+
+            boost::hash_combine(fp_, canon_[obj]);
+            return /* continue */ true;
+        }
+};
+
+THeapFingerprint heapFingerprint(const SymHeap &sh)
+{
+    SymHeap &shWritable = const_cast<SymHeap &>(sh);
+    THeapFingerprint fp = 0U;
+
+    // program variables are matched by their identity
+    TCVarSet vars;
+    gatherProgramVars(vars, sh);
+    TFpWorkList wl;
+    TCanonMap canon;
+    BOOST_FOREACH(const CVar &cv, vars) {
+        boost::hash_combine(fp, cv.uid);
+        boost::hash_combine(fp, cv.inst);
+
+        const TObjId obj = shWritable.regionByVar(cv, /* createIfNeeded */false);
+        wl.schedule(obj);
+        const int id = canon.size();
+        canon[obj] = id;
+    }
+
+    // traverse the pointer structure the same way as dfsCmp() does
+    FingerprintVisitor visitor(wl, canon, fp, shWritable);
+    SymHeap *const heaps[] = { &shWritable };
+    TObjId obj;
+    while (wl.next(obj)) {
+        const TObjId objs[] = { obj };
+        traverseLiveFieldsGeneric<1>(heaps, objs, visitor);
+    }
+
+    return fp;
+}
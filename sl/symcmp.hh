@@ -37,6 +37,19 @@ bool areEqual(
         const SymHeap           &sh1,
         const SymHeap           &sh2);
 
+/// hash of a symbolic heap that is invariant w.r.t. heap isomorphism
+typedef size_t                                              THeapFingerprint;
+
+/**
+ * compute a cheap fingerprint of the given symbolic heap such that
+ * areEqual(sh1, sh2) implies heapFingerprint(sh1) == heapFingerprint(sh2)
+ *
+ * The heap is traversed in the same order as areEqual() does it, starting at
+ * program variables.  Only the pointer structure is hashed, which is
+ * sufficient to quickly rule out the most of the heaps that can never match.
+ */
+THeapFingerprint heapFingerprint(const SymHeap &sh);
+
 inline bool checkNonPosValues(int a, int b)
 {
     if (0 < a && 0 < b)
@@ -33,6 +33,7 @@
 #include "symcall.hh"
 #include "symdebug.hh"
 #include "symproc.hh"
+#include "symprof.hh"
 #include "symstate.hh"
 #include "symutil.hh"
 #include "symtrace.hh"
@@ -638,12 +639,15 @@ bool /* complete */ SymExecEngine::execInsn()
 
             // mark as processed now since it can be re-scheduled right away
             origin.setDone(heapIdx_);
+            Profile::count(Profile::PC_HEAPS);
         }
 
         // capture fixed-point for plotting if configured to do so
         if (GlConf::data.fixedPoint)
             GlConf::data.fixedPoint->insert(insn, localState_[heapIdx_]);
 
+        Profile::count(Profile::PC_INSNS);
+
         if (nextInsnIsCond)
             // this is going to be handled in execCondInsn() right away
             continue;
@@ -697,6 +701,7 @@ bool /* complete */ SymExecEngine::execBlock()
         // fresh run, let's initialize the local state by the BB entry
         const SymState &origin = stateMap_[block_];
         localState_ = origin;
+        Profile::updatePeakHeaps(origin.size());
 
         // eliminate the unneeded Trace::CloneNode instances
         Trace::waiveCloneOperation(localState_);
@@ -768,6 +773,7 @@ bool /* complete */ SymExecEngine::run()
 
     if (waiting_) {
         // pick up results of the pending call
+        Profile::enterBlock(bt_.topFnc(), block_);
         this->joinCallResults();
 
         // we're on the way from a just completed function call...
@@ -790,6 +796,7 @@ bool /* complete */ SymExecEngine::run()
         lw_ = &first->loc;
 
         // enter the basic block
+        Profile::enterBlock(bt_.topFnc(), block_);
         const std::string &name = block_->name();
         CL_DEBUG_MSG(lw_, "___ entering " << name << ", " << fncName_
                      << "(), " << sched_.cntWaiting()
@@ -817,6 +824,7 @@ bool /* complete */ SymExecEngine::run()
     }
 
     // we are done with this function
+    sched_.printVisitStats(loc);
     CL_DEBUG_MSG(loc, "<<< leaving " << nameOf(fnc) << "()");
     waiting_ = false;
 
@@ -1214,6 +1222,7 @@ void SymExec::execFnc(
 
         if (!ctx->needExec()) {
             // call cache hit
+            Profile::count(Profile::PC_CALL_CACHE_HIT);
             const struct cl_loc *loc = &insn.loc;
             const std::string name = nameOf(*fnc);
             CL_DEBUG_MSG(loc,
@@ -1227,18 +1236,20 @@ void SymExec::execFnc(
         }
 
         // create a new engine and push it to the exec stack
+        Profile::count(Profile::PC_CALL_CACHE_MISS);
         this->enterCall(ctx, engine->callResults());
     }
 }
 
 void SymExec::printStats() const
 {
-    // TODO: print SymCallCache stats here as soon as we have implemented some
-
     BOOST_FOREACH(const ExecStackItem &item, execStack_) {
         const IStatsProvider *provider = item.eng;
         provider->printStats();
     }
+
+    callCache_.printStats();
+    printJoinStats();
 }
 
 void execTopCall(
@@ -1253,6 +1264,8 @@ void execTopCall(
     try {
         SymExec se(entry.stor());
         se.execFnc(results, entry, insn, fnc);
+        Profile::leaveBlock();
+        se.printStats();
         // SymExec::~SymExec() is going to be executed as leaving this block
     }
     catch (const std::runtime_error &e) {
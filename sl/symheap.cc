@@ -23,9 +23,11 @@
 
 #include <cl/cl_msg.hh>
 #include <cl/clutil.hh>
+#include <cl/mempool.hh>
 #include <cl/storage.hh>
 
 #include "intarena.hh"
+#include "persistent.hh"
 #include "syments.hh"
 #include "sympred.hh"
 #include "symutil.hh"
@@ -121,7 +123,11 @@ class CVarMap {
         RefCounter refCnt;
 
     private:
+#if SH_PERSISTENT_CONTAINERS
+        typedef PersistentMap<CVar, TObjId>         TCont;
+#else
         typedef std::map<CVar, TObjId>              TCont;
+#endif
         TCont                                       cont_;
 
     public:
@@ -140,7 +146,7 @@ class CVarMap {
 
         TObjId find(const CVar &cVar) {
             // regular lookup
-            TCont::iterator iter = cont_.find(cVar);
+            TCont::const_iterator iter = cont_.find(cVar);
             const bool found = (cont_.end() != iter);
             if (!cVar.inst) {
                 // gl variable explicitly requested
@@ -152,7 +158,7 @@ class CVarMap {
             // automatic fallback to gl variable
             CVar gl = cVar;
             gl.inst = /* global variable */ 0;
-            TCont::iterator iterGl = cont_.find(gl);
+            TCont::const_iterator iterGl = cont_.find(gl);
             const bool foundGl = (cont_.end() != iterGl);
 
             if (!found && !foundGl)
@@ -273,13 +279,28 @@ bool operator==(const CustomValue &a, const CustomValue &b)
 // /////////////////////////////////////////////////////////////////////////////
 // implementation of SymHeapCore
 typedef std::set<TObjId>                                TObjSet;
-typedef std::set<TFldId>                                TFldIdSet;
-typedef std::map<TOffset, TValId>                       TOffMap;
+#if SH_POOL_ALLOCATOR
+typedef IntervalArena<TOffset, TFldId, PoolAllocator<TFldId> >  TArena;
+typedef std::map<TOffset, TValId, std::less<TOffset>,
+        PoolAllocator<std::pair<const TOffset, TValId> > >     TOffMap;
+#else
 typedef IntervalArena<TOffset, TFldId>                  TArena;
+typedef std::map<TOffset, TValId>                       TOffMap;
+#endif
+typedef TArena::TSet                                    TFldIdSet;
 typedef TArena::key_type                                TMemChunk;
 typedef TArena::value_type                              TMemItem;
+#if SH_PERSISTENT_CONTAINERS
+typedef PersistentMap<CallInst, TObjList>               TAnonStackMap;
+#else
 typedef std::map<CallInst, TObjList>                    TAnonStackMap;
+#endif
+#if SH_POOL_ALLOCATOR
+typedef std::map<ETargetSpecifier, TValId, std::less<ETargetSpecifier>,
+        PoolAllocator<std::pair<const ETargetSpecifier, TValId> > > TAddrByTS;
+#else
 typedef std::map<ETargetSpecifier, TValId>              TAddrByTS;
+#endif
 
 inline TMemItem createArenaItem(
         const TOffset               off,
@@ -329,7 +350,12 @@ enum EBlockKind {
     BK_UNIFORM
 };
 
+#if SH_POOL_ALLOCATOR
+typedef std::map<TFldId, EBlockKind, std::less<TFldId>,
+        PoolAllocator<std::pair<const TFldId, EBlockKind> > >   TLiveObjs;
+#else
 typedef std::map<TFldId, EBlockKind>                    TLiveObjs;
+#endif
 
 inline EBlockKind bkFromClt(const TObjType clt)
 {
@@ -342,6 +368,17 @@ class AbstractHeapEntity {
     public:
         virtual AbstractHeapEntity* clone() const = 0;
 
+#if SH_POOL_ALLOCATOR
+        static void* operator new(size_t size) {
+            return poolAlloc(size);
+        }
+
+        // the size is that of the most derived type (the destructor is virtual)
+        static void operator delete(void *ptr, size_t size) {
+            poolFree(ptr, size);
+        }
+#endif
+
     protected:
         virtual ~AbstractHeapEntity() { }
         friend class EntStore<AbstractHeapEntity>;
@@ -527,10 +564,17 @@ struct BaseAddress: public AnchorValue {
 // cppcheck-suppress noConstructor
 class CustomValueMapper {
     private:
+#if SH_PERSISTENT_CONTAINERS
+        typedef PersistentMap<int /* uid */, TValId>            TCustomByUid;
+        typedef PersistentMap<IR::TInt, TValId>                 TCustomByNum;
+        typedef PersistentMap<double, TValId>                   TCustomByReal;
+        typedef PersistentMap<std::string, TValId>              TCustomByString;
+#else
         typedef std::map<int /* uid */, TValId>                 TCustomByUid;
         typedef std::map<IR::TInt, TValId>                      TCustomByNum;
         typedef std::map<double, TValId>                        TCustomByReal;
         typedef std::map<std::string, TValId>                   TCustomByString;
+#endif
 
         TCustomByUid        fncMap;
         TCustomByNum        numMap;
@@ -566,10 +610,16 @@ class CustomValueMapper {
         }
 };
 
+#if SH_PERSISTENT_CONTAINERS
+struct TObjSetWrapper: public PersistentSet<TObjId> {
+    RefCounter refCnt;
+};
+#else
 // FIXME: std::set is not a good candidate for base class
 struct TObjSetWrapper: public TObjSet {
     RefCounter refCnt;
 };
+#endif
 
 // FIXME: std::map is not a good candidate for base class
 struct TAnonStackMapWrapper: public TAnonStackMap {
@@ -3264,17 +3314,17 @@ void SymHeapCore::clearAnonStackObjects(TObjList &dst, const CallInst &of)
 {
     CL_BREAK_IF(!dst.empty());
 
-    TAnonStackMap &sMap = *d->anonStackMap;
-    const TAnonStackMap::iterator it = sMap.find(of);
+    const TAnonStackMap &sMap = *d->anonStackMap;
+    const TAnonStackMap::const_iterator it = sMap.find(of);
     if (sMap.end() == it)
         return;
 
     // return the list of anonymous stack objects
     dst = it->second;
 
-    // clear the list of anonymous stack objects
+    // clear the list of anonymous stack objects (the map may be cloned here)
     RefCntLib<RCO_NON_VIRT>::requireExclusivity(d->anonStackMap);
-    sMap.erase(it);
+    d->anonStackMap->erase(of);
 }
 
 TFldId SymHeapCore::valGetComposite(TValId val) const
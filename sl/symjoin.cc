@@ -29,6 +29,7 @@
 #include "symcmp.hh"
 #include "symgc.hh"
 #include "symplot.hh"
+#include "symprof.hh"
 #include "symseg.hh"
 #include "symutil.hh"
 #include "symtrace.hh"
@@ -2490,6 +2491,7 @@ bool joinSymHeaps(
         const bool               allowThreeWay)
 {
     SJ_DEBUG("--> joinSymHeaps()");
+    Profile::count(Profile::PC_JOIN_TRIED);
     TStorRef stor = sh1.stor();
     CL_BREAK_IF(&stor != &sh2.stor());
 
@@ -2542,6 +2544,7 @@ bool joinSymHeaps(
 
     // all OK
     *pStatus = ctx.status;
+    Profile::count(Profile::PC_JOIN_DONE);
     SJ_DEBUG("<-- joinSymHeaps() says " << ctx.status);
     CL_BREAK_IF(!segCheckConsistency(ctx.dst));
     CL_BREAK_IF(!protoCheckConsistency(ctx.dst));
@@ -2553,6 +2556,26 @@ fail:
     return false;
 }
 
+void joinSignature(JoinSignature *pDst, const SymHeap &sh)
+{
+    TCVarSet &glVars = pDst->glVars;
+    glVars.clear();
+
+    TCVarList vars;
+    gatherProgramVars(vars, sh);
+    BOOST_FOREACH(const CVar &cv, vars)
+        if (!cv.inst)
+            glVars.insert(cv);
+}
+
+bool joinSignaturesMatch(
+        const JoinSignature     &sig1,
+        const JoinSignature     &sig2)
+{
+    // asymmetric join of gl variables would break everything
+    return (sig1.glVars == sig2.glVars);
+}
+
 // FIXME: this works only for nullified blocks anyway
 void killUniBlocksUnderBindingPtrs(
         SymHeap                &sh,
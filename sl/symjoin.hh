@@ -71,6 +71,25 @@ bool joinSymHeaps(
         SymHeap                  sh2,
         const bool               allowThreeWay = true);
 
+/// cheap summary of a symbolic heap used to rule out joins bound to fail
+struct JoinSignature {
+    /// live global variables, which cannot be recovered asymmetrically
+    TCVarSet            glVars;
+};
+
+/// compute the JoinSignature of the given symbolic heap
+void joinSignature(JoinSignature *pDst, const SymHeap &sh);
+
+/**
+ * return false if joinSymHeaps() is guaranteed to fail for any pair of heaps
+ * with the given signatures, true if it may succeed
+ * @note The signature covers only what no join can recover, the three-way join
+ * can introduce almost anything else.
+ */
+bool joinSignaturesMatch(
+        const JoinSignature     &sig1,
+        const JoinSignature     &sig2);
+
 /// enable/disable debugging of symjoin
 void debugSymJoin(const bool enable);
 
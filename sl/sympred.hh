@@ -21,6 +21,7 @@
 #define H_GUARD_SYM_PRED_H
 
 #include "config.h"
+#include "persistent.hh"
 #include "util.hh"
 
 #include <map>
@@ -31,7 +32,11 @@ template <class TKey, bool IREFLEXIVE>
 class SymPairSet {
     protected:
         typedef std::pair<TKey /* lt */, TKey /* gt */>     TItem;
+#if SH_PERSISTENT_CONTAINERS
+        typedef PersistentSet<TItem>                        TCont;
+#else
         typedef std::set<TItem>                             TCont;
+#endif
         TCont cont_;
 
     public:
@@ -66,7 +71,11 @@ template <class TKey, class TVal>
 class SymPairMap {
     protected:
         typedef std::pair<TKey /* lt */, TKey /* gt */>     TItem;
+#if SH_PERSISTENT_CONTAINERS
+        typedef PersistentMap<TItem, TVal>                  TMap;
+#else
         typedef std::map<TItem, TVal>                       TMap;
+#endif
         TMap db_;
 
     public:
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "symprof.hh"
+
+#include <cl/cl_msg.hh>
+#include <cl/storage.hh>
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+
+#include <sys/time.h>
+
+#include <boost/foreach.hpp>
+
+namespace Profile {
+
+struct Counters {
+    double                      wallTime;
+    unsigned long               cnt[PC_TOTAL];
+    unsigned                    peakHeaps;
+
+    Counters():
+        wallTime(0.0),
+        peakHeaps(0U)
+    {
+        for (int i = 0; i < PC_TOTAL; ++i)
+            cnt[i] = 0UL;
+    }
+
+    void add(const Counters &other) {
+        wallTime += other.wallTime;
+        for (int i = 0; i < PC_TOTAL; ++i)
+            cnt[i] += other.cnt[i];
+
+        if (peakHeaps < other.peakHeaps)
+            peakHeaps = other.peakHeaps;
+    }
+};
+
+struct BlockProfile: public Counters {
+    const CodeStorage::Fnc     *fnc;
+
+    BlockProfile():
+        fnc(0)
+    {
+    }
+};
+
+typedef const CodeStorage::Block                   *TBlock;
+typedef std::map<TBlock, BlockProfile>              TBlockMap;
+
+struct Data {
+    bool                        enabled;
+    double                      lastSwitch;
+    TBlockMap                   blocks;
+    Counters                    global;     ///< events outside of any block
+    Counters                   *current;
+
+    Data():
+        enabled(false),
+        lastSwitch(0.0),
+        current(&global)
+    {
+    }
+};
+
+static Data data;
+
+static double wallClock()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+static void chargeElapsedTime()
+{
+    const double now = wallClock();
+    data.current->wallTime += now - data.lastSwitch;
+    data.lastSwitch = now;
+}
+
+void enable()
+{
+    data.enabled = true;
+    data.lastSwitch = wallClock();
+}
+
+bool enabled()
+{
+    return data.enabled;
+}
+
+void enterBlock(const CodeStorage::Fnc *fnc, const CodeStorage::Block *bb)
+{
+    if (!data.enabled)
+        return;
+
+    chargeElapsedTime();
+
+    BlockProfile &prof = data.blocks[bb];
+    prof.fnc = fnc;
+    data.current = &prof;
+}
+
+void leaveBlock()
+{
+    if (!data.enabled)
+        return;
+
+    chargeElapsedTime();
+    data.current = &data.global;
+}
+
+void count(ECounter which, unsigned cnt)
+{
+    if (data.enabled)
+        data.current->cnt[which] += cnt;
+}
+
+void updatePeakHeaps(unsigned cntHeaps)
+{
+    if (data.enabled && data.current->peakHeaps < cntHeaps)
+        data.current->peakHeaps = cntHeaps;
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// JSON writer
+static const char *counterNames[PC_TOTAL] = {
+    "insns",
+    "heaps",
+    "join_tried",
+    "join_done",
+    "are_equal",
+    "call_cache_hits",
+    "call_cache_misses",
+    "abstraction_steps"
+};
+
+static void writeString(std::ostream &str, const char *raw)
+{
+    str << "\"";
+    for (const char *pc = raw; pc && *pc; ++pc) {
+        const unsigned char c = *pc;
+        switch (c) {
+            case '"':
+            case '\\':
+                str << "\\" << c;
+                break;
+
+            case '\n':
+                str << "\\n";
+                break;
+
+            case '\t':
+                str << "\\t";
+                break;
+
+            default:
+                if (c < 0x20)
+                    str << "\\u" << std::hex << std::setw(4)
+                        << std::setfill('0') << static_cast<int>(c)
+                        << std::dec << std::setfill(' ');
+                else
+                    str << c;
+        }
+    }
+    str << "\"";
+}
+
+static void writeLoc(std::ostream &str, const struct cl_loc *loc)
+{
+    str << "\"file\": ";
+    writeString(str, loc->file);
+    str << ", \"line\": " << loc->line;
+}
+
+static void writeCounters(std::ostream &str, const Counters &cnts)
+{
+    str << "\"wall_time\": " << std::fixed << std::setprecision(6)
+        << cnts.wallTime;
+
+    for (int i = 0; i < PC_TOTAL; ++i)
+        str << ", \"" << counterNames[i] << "\": " << cnts.cnt[i];
+
+    str << ", \"peak_heaps\": " << cnts.peakHeaps;
+}
+
+struct FncUidLess {
+    bool operator()(const CodeStorage::Fnc *a, const CodeStorage::Fnc *b) const
+    {
+        return uidOf(*a) < uidOf(*b);
+    }
+};
+
+typedef std::set<const CodeStorage::Fnc *, FncUidLess>  TFncSet;
+
+static void writeFnc(std::ostream &str, const CodeStorage::Fnc &fnc)
+{
+    // first aggregate the per-block counters
+    Counters total;
+    BOOST_FOREACH(const CodeStorage::Block *bb, fnc.cfg) {
+        const TBlockMap::const_iterator it = data.blocks.find(bb);
+        if (data.blocks.end() != it)
+            total.add(it->second);
+    }
+
+    str << "    {\"name\": ";
+    writeString(str, nameOf(fnc));
+    str << ", \"uid\": " << uidOf(fnc) << ", ";
+    writeLoc(str, locationOf(fnc));
+    str << ", ";
+    writeCounters(str, total);
+    str << ",\n      \"blocks\": [";
+
+    // then print the blocks in the order given by the control flow graph
+    bool first = true;
+    BOOST_FOREACH(const CodeStorage::Block *bb, fnc.cfg) {
+        const TBlockMap::const_iterator it = data.blocks.find(bb);
+        if (data.blocks.end() == it)
+            // not reached by the analysis
+            continue;
+
+        str << ((first) ? "\n" : ",\n");
+        first = false;
+
+        str << "        {\"name\": ";
+        writeString(str, bb->name().c_str());
+        str << ", ";
+        writeLoc(str, &bb->front()->loc);
+        str << ", ";
+        writeCounters(str, it->second);
+        str << "}";
+    }
+
+    str << "\n      ]}";
+}
+
+bool writeJson(const std::string &fileName)
+{
+    if (!data.enabled)
+        return false;
+
+    // charge the time elapsed since the last block switch
+    leaveBlock();
+
+    std::fstream str(fileName.c_str(), std::ios::out);
+    if (!str) {
+        CL_ERROR("unable to create file '" << fileName << "'");
+        return false;
+    }
+
+    // gather the functions that have been analyzed
+    TFncSet fncs;
+    Counters total(data.global);
+    BOOST_FOREACH(TBlockMap::const_reference item, data.blocks) {
+        fncs.insert(item.second.fnc);
+        total.add(item.second);
+    }
+
+    str << "{\n  \"version\": ";
+    writeString(str, GIT_SHA1);
+    str << ",\n  \"total\": {";
+    writeCounters(str, total);
+    str << "},\n  \"functions\": [";
+
+    bool first = true;
+    BOOST_FOREACH(const CodeStorage::Fnc *fnc, fncs) {
+        str << ((first) ? "\n" : ",\n");
+        first = false;
+        writeFnc(str, *fnc);
+    }
+
+    str << "\n  ]\n}\n";
+    str.close();
+    if (!str) {
+        CL_ERROR("failed to write profile to '" << fileName << "'");
+        return false;
+    }
+
+    CL_DEBUG("profile of " << fncs.size() << " function(s) written to '"
+            << fileName << "'");
+    return true;
+}
+
+} // namespace Profile
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_SYM_PROF_H
+#define H_GUARD_SYM_PROF_H
+
+/**
+ * @file symprof.hh
+ * per-function and per-block @b profile of the symbolic execution, which can
+ * be written as a JSON document once the analysis is done
+ */
+
+#include <string>
+
+namespace CodeStorage {
+    struct Block;
+    struct Fnc;
+}
+
+namespace Profile {
+
+/// kinds of events counted by the profiler
+enum ECounter {
+    PC_INSNS,               ///< instructions executed (counted per heap)
+    PC_HEAPS,               ///< heaps taken from the block scheduler
+    PC_JOIN_TRIED,          ///< calls of joinSymHeaps()
+    PC_JOIN_DONE,           ///< successful calls of joinSymHeaps()
+    PC_ARE_EQUAL,           ///< calls of areEqual()
+    PC_CALL_CACHE_HIT,      ///< calls optimized out by SymCallCache
+    PC_CALL_CACHE_MISS,     ///< calls that needed to be executed
+    PC_ABSTRACT_STEPS,      ///< successful segment abstraction steps
+    PC_TOTAL
+};
+
+/// start collecting the profile, nothing is recorded until this is called
+void enable();
+
+/// true if the profile is being collected
+bool enabled();
+
+/**
+ * charge the wall time elapsed since the last switch to the current block and
+ * make bb (which belongs to fnc) the current block
+ */
+void enterBlock(const CodeStorage::Fnc *fnc, const CodeStorage::Block *bb);
+
+/// charge the elapsed wall time to the current block and detach from it
+void leaveBlock();
+
+/// increment the given counter of the current block
+void count(ECounter, unsigned cnt = 1U);
+
+/// update the peak count of heaps in the state of the current block
+void updatePeakHeaps(unsigned cntHeaps);
+
+/// write the collected profile as a JSON document, return false on failure
+bool writeJson(const std::string &fileName);
+
+} // namespace Profile
+
+#endif /* H_GUARD_SYM_PROF_H */
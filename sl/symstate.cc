@@ -23,6 +23,7 @@
 #include <cl/cl_msg.hh>
 #include <cl/storage.hh>
 
+#include "glconf.hh"
 #include "symcmp.hh"
 #include "symjoin.hh"
 #include "symplot.hh"
@@ -33,9 +34,11 @@
 
 #include <algorithm>            // for std::copy_if
 #include <iomanip>
+#include <list>
 #include <map>
 
 #include <boost/foreach.hpp>
+#include <boost/tuple/tuple.hpp>
 
 #if !SE_BLOCK_SCHEDULER_KIND
 #   include <queue>
@@ -46,6 +49,9 @@ static bool debugSymState = static_cast<bool>(DEBUG_SYMSTATE);
 
 static int cntLookups = -1;
 
+static int cntJoinsTried;
+static int cntJoinsAvoided;
+
 namespace {
     void debugPlot(const char *name, int idx, const SymHeap &sh) {
 #if DEBUG_SYMJOIN
@@ -127,7 +133,84 @@ void SymState::rotateExisting(const int idxA, const int idxB)
 
 // /////////////////////////////////////////////////////////////////////////////
 // SymHeapUnion implementation
-int SymHeapUnion::lookup(const SymHeap &lookFor) const
+void SymHeapUnion::syncIndex() const
+{
+    const unsigned cnt = this->size();
+    CL_BREAK_IF(cnt < fps_.size());
+
+    if (fpIndex_.size() != fps_.size()) {
+        // the index has been invalidated, rebuild it from the fingerprints
+        fpIndex_.clear();
+        for (unsigned idx = 0U; idx < fps_.size(); ++idx)
+            fpIndex_.insert(TFpIndex::value_type(fps_[idx], idx));
+    }
+
+    // compute fingerprints of the heaps inserted since the last lookup
+    for (unsigned idx = fps_.size(); idx < cnt; ++idx) {
+        const THeapFingerprint fp = heapFingerprint(this->operator[](idx));
+        fps_.push_back(fp);
+        fpIndex_.insert(TFpIndex::value_type(fp, idx));
+    }
+}
+
+void SymHeapUnion::clear()
+{
+    SymState::clear();
+    fps_.clear();
+    fpIndex_.clear();
+}
+
+void SymHeapUnion::swap(SymState &other)
+{
+    SymState::swap(other);
+    fps_.clear();
+    fpIndex_.clear();
+
+    SymHeapUnion *huni = dynamic_cast<SymHeapUnion *>(&other);
+    if (!huni)
+        return;
+
+    huni->fps_.clear();
+    huni->fpIndex_.clear();
+}
+
+void SymHeapUnion::eraseExisting(int nth)
+{
+    SymState::eraseExisting(nth);
+    if (static_cast<unsigned>(nth) < fps_.size())
+        fps_.erase(fps_.begin() + nth);
+
+    // the indices have shifted, let syncIndex() rebuild the index
+    fpIndex_.clear();
+}
+
+void SymHeapUnion::swapExisting(int nth, SymHeap &sh)
+{
+    SymState::swapExisting(nth, sh);
+    if (fps_.size() <= static_cast<unsigned>(nth))
+        // fingerprint not computed yet
+        return;
+
+    fps_[nth] = heapFingerprint(this->operator[](nth));
+    fpIndex_.clear();
+}
+
+void SymHeapUnion::rotateExisting(const int idxA, const int idxB)
+{
+    SymState::rotateExisting(idxA, idxB);
+    if (fps_.size() == this->size()) {
+        TFpList::iterator itA = fps_.begin() + idxA;
+        TFpList::iterator itB = fps_.begin() + idxB;
+        rotate(itA, itB, fps_.end());
+    }
+    else if (static_cast<unsigned>(idxA) < fps_.size())
+        // keep only the prefix that has not moved
+        fps_.resize(idxA);
+
+    fpIndex_.clear();
+}
+
+int SymHeapUnion::lookup(const SymHeap &lookFor, unsigned *pCntProbes) const
 {
     const int cnt = this->size();
     if (!cnt)
@@ -137,12 +220,22 @@ int SymHeapUnion::lookup(const SymHeap &lookFor) const
     ++::cntLookups;
     debugPlot("lookup", 0, lookFor);
 
-    for(int idx = 0; idx < cnt; ++idx) {
+    // compare only heaps with the same fingerprint
+    this->syncIndex();
+    const THeapFingerprint fp = heapFingerprint(lookFor);
+    TFpIndex::const_iterator it, itEnd;
+    boost::tie(it, itEnd) = fpIndex_.equal_range(fp);
+
+    for(; it != itEnd; ++it) {
+        const int idx = it->second;
         const int nth = idx + 1;
 
         const SymHeap &sh = this->operator[](idx);
         debugPlot("lookup", nth, sh);
 
+        if (pCntProbes)
+            ++(*pCntProbes);
+
         if (areEqual(lookFor, sh)) {
             CL_DEBUG("<I> sh #" << idx << " is equal to the given one, "
                     << cnt << " heaps in total");
@@ -162,8 +255,80 @@ int SymHeapUnion::lookup(const SymHeap &lookFor) const
 
 // /////////////////////////////////////////////////////////////////////////////
 // SymStateWithJoin implementation
+void SymStateWithJoin::clear()
+{
+    SymHeapUnion::clear();
+    sigs_.clear();
+}
+
+void SymStateWithJoin::swap(SymState &other)
+{
+    SymHeapUnion::swap(other);
+    sigs_.clear();
+
+    SymStateWithJoin *state = dynamic_cast<SymStateWithJoin *>(&other);
+    if (state)
+        state->sigs_.clear();
+}
+
+void SymStateWithJoin::eraseExisting(int nth)
+{
+    SymHeapUnion::eraseExisting(nth);
+    if (static_cast<unsigned>(nth) < sigs_.size())
+        sigs_.erase(sigs_.begin() + nth);
+}
+
+void SymStateWithJoin::swapExisting(int nth, SymHeap &sh)
+{
+    SymHeapUnion::swapExisting(nth, sh);
+    if (static_cast<unsigned>(nth) < sigs_.size())
+        joinSignature(&sigs_[nth], this->operator[](nth));
+}
+
+void SymStateWithJoin::rotateExisting(const int idxA, const int idxB)
+{
+    if (!sigs_.empty())
+        // complete the signatures so that we can rotate them along with heaps
+        this->sigByIdx(this->size() - 1U);
+
+    SymHeapUnion::rotateExisting(idxA, idxB);
+    if (sigs_.empty())
+        return;
+
+    TSigList::iterator itA = sigs_.begin() + idxA;
+    TSigList::iterator itB = sigs_.begin() + idxB;
+    rotate(itA, itB, sigs_.end());
+}
+
+const JoinSignature& SymStateWithJoin::sigByIdx(unsigned nth)
+{
+    CL_BREAK_IF(this->size() <= nth);
+
+    for (unsigned idx = sigs_.size(); idx <= nth; ++idx) {
+        sigs_.push_back(JoinSignature());
+        joinSignature(&sigs_.back(), this->operator[](idx));
+    }
+
+    return sigs_[nth];
+}
+
+bool SymStateWithJoin::joinMayMatch(
+        unsigned                idxOld,
+        const JoinSignature     &sigNew)
+{
+    ++::cntJoinsTried;
+    if (joinSignaturesMatch(this->sigByIdx(idxOld), sigNew))
+        return true;
+
+    ++::cntJoinsAvoided;
+    return false;
+}
+
 void SymStateWithJoin::packState(unsigned idxNew, bool allowThreeWay)
 {
+    // the signature may be invalidated by erasing heaps, keep a copy
+    JoinSignature sigNew = this->sigByIdx(idxNew);
+
     for (unsigned idxOld = 0U; idxOld < this->size();) {
         if (idxNew == idxOld) {
             // do not remove the newly inserted heap based on identity with self
@@ -171,6 +336,11 @@ void SymStateWithJoin::packState(unsigned idxNew, bool allowThreeWay)
             continue;
         }
 
+        if (!this->joinMayMatch(idxOld, sigNew)) {
+            ++idxOld;
+            continue;
+        }
+
         SymHeap &shOld = const_cast<SymHeap &>(this->operator[](idxOld));
         SymHeap &shNew = const_cast<SymHeap &>(this->operator[](idxNew));
 
@@ -207,6 +377,9 @@ void SymStateWithJoin::packState(unsigned idxNew, bool allowThreeWay)
             --idxNew;
 
         this->eraseExisting(idxOld);
+
+        // the heap at idxNew may have been replaced by the join
+        sigNew = this->sigByIdx(idxNew);
     }
 
 #if SE_STATE_ON_THE_FLY_ORDERING
@@ -235,8 +408,14 @@ bool SymStateWithJoin::insert(const SymHeap &shNew, bool allowThreeWay)
             new Trace::TransientNode("SymStateWithJoin::insert()"));
     int             idx;
 
+    JoinSignature sigNew;
+    joinSignature(&sigNew, shNew);
+
     ++::cntLookups;
     for(idx = 0; idx < cnt; ++idx) {
+        if (!this->joinMayMatch(idx, sigNew))
+            continue;
+
         const SymHeap &shOld = this->operator[](idx);
         if (joinSymHeaps(&status, &result, shOld, shNew, allowThreeWay))
             // join succeeded
@@ -246,6 +425,10 @@ bool SymStateWithJoin::insert(const SymHeap &shNew, bool allowThreeWay)
     if (idx == cnt) {
         // nothing to join here
         this->insertNew(shNew);
+        if (sigs_.size() + 1U == this->size())
+            // reuse the signature we have already computed
+            sigs_.push_back(sigNew);
+
         return true;
     }
 
@@ -301,6 +484,128 @@ bool SymStateWithJoin::insert(const SymHeap &shNew, bool allowThreeWay)
     return false;
 }
 
+void printJoinStats()
+{
+    CL_DEBUG("SymStateWithJoin: " << ::cntJoinsAvoided << " of "
+            << ::cntJoinsTried << " join(s) avoided by JoinSignature");
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// weak topological ordering of basic blocks (F. Bourdoncle, 1993)
+typedef BlockScheduler::TBlock                              TBlock;
+typedef std::map<TBlock, unsigned /* position */>           TWtoIndex;
+
+class WtoBuilder {
+    public:
+        WtoBuilder(const CodeStorage::ControlFlow &cfg):
+            cfg_(cfg),
+            cnt_(0U)
+        {
+        }
+
+        void computeIndex(TWtoIndex *pDst);
+
+    private:
+        typedef std::list<TBlock>                           TPartition;
+
+        const CodeStorage::ControlFlow                     &cfg_;
+        std::map<TBlock, unsigned /* DFN */>                dfn_;
+        std::vector<TBlock>                                 stack_;
+        unsigned                                            cnt_;
+
+        static const unsigned INF = static_cast<unsigned>(-1);
+
+        unsigned visit(TBlock bb, TPartition &partition);
+        void component(TBlock head, TPartition &partition);
+};
+
+unsigned WtoBuilder::visit(const TBlock bb, TPartition &partition)
+{
+    stack_.push_back(bb);
+    unsigned head = dfn_[bb] = ++cnt_;
+    bool loop = false;
+
+    BOOST_FOREACH(const TBlock succ, bb->targets()) {
+        const unsigned dfnSucc = dfn_[succ];
+        const unsigned min = (dfnSucc)
+            ? dfnSucc
+            : this->visit(succ, partition);
+
+        if (min <= head) {
+            head = min;
+            loop = true;
+        }
+    }
+
+    if (head != dfn_[bb])
+        // bb belongs to a component with its head deeper in the stack
+        return head;
+
+    dfn_[bb] = INF;
+    TBlock top = stack_.back();
+    stack_.pop_back();
+
+    if (!loop) {
+        partition.push_front(bb);
+        return head;
+    }
+
+    // bb is the head of a component, the component will be visited again
+    while (top != bb) {
+        dfn_[top] = 0U;
+        top = stack_.back();
+        stack_.pop_back();
+    }
+
+    this->component(bb, partition);
+    return head;
+}
+
+void WtoBuilder::component(const TBlock head, TPartition &partition)
+{
+    TPartition body;
+    BOOST_FOREACH(const TBlock succ, head->targets())
+        if (!dfn_[succ])
+            this->visit(succ, body);
+
+    // the head goes first, followed by the (recursively ordered) body
+    body.push_front(head);
+    partition.splice(partition.begin(), body);
+}
+
+void WtoBuilder::computeIndex(TWtoIndex *pDst)
+{
+    const TBlock entry = cfg_.entry();
+    if (!entry)
+        return;
+
+    TPartition wto;
+    this->visit(entry, wto);
+
+    unsigned pos = 0U;
+    BOOST_FOREACH(const TBlock bb, wto)
+        (*pDst)[bb] = pos++;
+}
+
+/// compute the ordering once per CFG, the results are kept till the end
+const TWtoIndex* wtoIndexOf(const CodeStorage::ControlFlow *cfg)
+{
+    typedef std::map<const CodeStorage::ControlFlow *, TWtoIndex> TCache;
+    static TCache cache;
+
+    TCache::iterator it = cache.find(cfg);
+    if (cache.end() != it)
+        return &it->second;
+
+    TWtoIndex &index = cache[cfg];
+    WtoBuilder(*cfg).computeIndex(&index);
+    CL_DEBUG("<Q> weak topological order of " << cfg->size()
+            << " basic block(s) computed");
+
+    return &index;
+}
+
 
 // /////////////////////////////////////////////////////////////////////////////
 // BlockScheduler implementation
@@ -310,7 +615,21 @@ struct BlockScheduler::Private {
 #elif SE_BLOCK_SCHEDULER_KIND < 3
     typedef std::vector<TBlock>                             TSched;
 #endif
-    typedef std::map<TBlock, unsigned /* cnt */>            TDone;
+    typedef std::pair<unsigned /* position */, TBlock>      TWtoItem;
+    typedef std::set<TWtoItem>                              TWtoSched;
+
+    struct BlockStats {
+        unsigned        cntVisits;
+        unsigned        cntHeaps;
+
+        BlockStats():
+            cntVisits(0U),
+            cntHeaps(0U)
+        {
+        }
+    };
+
+    typedef std::map<TBlock, BlockStats>                    TDone;
 
     TBlockSet           todo;
 #if SE_BLOCK_SCHEDULER_KIND < 3
@@ -318,12 +637,36 @@ struct BlockScheduler::Private {
 #endif
     TDone               done;
 
+    // used only if GlConf::data.wtoScheduler is set
+    bool                useWto;
+    const TWtoIndex    *wtoIndex;
+    TWtoSched           wtoSched;
+
     const IPendingCountProvider *pcp;
+
+    unsigned wtoPositionOf(const TBlock bb);
+    TBlock pickByPolicy();
 };
 
+unsigned BlockScheduler::Private::wtoPositionOf(const TBlock bb)
+{
+    if (!this->wtoIndex)
+        this->wtoIndex = wtoIndexOf(bb->cfg());
+
+    const TWtoIndex::const_iterator it = this->wtoIndex->find(bb);
+    if (this->wtoIndex->end() != it)
+        return it->second;
+
+    // not reachable from the entry block, put it at the end
+    CL_BREAK_IF("BlockScheduler::wtoPositionOf() got an unreachable block");
+    return this->wtoIndex->size();
+}
+
 BlockScheduler::BlockScheduler(const IPendingCountProvider &pcp):
     d(new Private)
 {
+    d->useWto = GlConf::data.wtoScheduler;
+    d->wtoIndex = 0;
     d->pcp = &pcp;
 }
 
@@ -358,6 +701,16 @@ BlockScheduler::TBlockList BlockScheduler::done() const
 
 bool BlockScheduler::schedule(const TBlock bb)
 {
+    if (d->useWto) {
+        if (!insertOnce(d->todo, bb))
+            // already in the queue, the position is given by WTO anyway
+            return false;
+
+        const unsigned pos = d->wtoPositionOf(bb);
+        d->wtoSched.insert(Private::TWtoItem(pos, bb));
+        return true;
+    }
+
     if (insertOnce(d->todo, bb)) {
 #if !SE_BLOCK_SCHEDULER_KIND
         d->sched.push(bb);
@@ -399,19 +752,15 @@ bool BlockScheduler::schedule(const TBlock bb)
     return false;
 }
 
-bool BlockScheduler::getNext(TBlock *dst)
+TBlock BlockScheduler::Private::pickByPolicy()
 {
-    if (d->todo.empty())
-        return false;
-
-    // select the block for processing according to the policy
     TBlock bb;
 #if !SE_BLOCK_SCHEDULER_KIND
-    bb = d->sched.front();
-    d->sched.pop();
+    bb = this->sched.front();
+    this->sched.pop();
 #elif SE_BLOCK_SCHEDULER_KIND < 3
-    bb = d->sched.back();
-    d->sched.pop_back();
+    bb = this->sched.back();
+    this->sched.pop_back();
 
 #else // assume load-driven scheduler
 
@@ -419,8 +768,8 @@ bool BlockScheduler::getNext(TBlock *dst)
     TLoad load;
 
     // this really needs to be sorted in getNext()
-    BOOST_FOREACH(const TBlock bbNow, d->todo) {
-        const int cntPending = d->pcp->cntPending(bbNow);
+    BOOST_FOREACH(const TBlock bbNow, this->todo) {
+        const int cntPending = this->pcp->cntPending(bbNow);
         load[cntPending] = bbNow;
     }
 
@@ -435,11 +784,34 @@ bool BlockScheduler::getNext(TBlock *dst)
             << itBottom->second->name() << " with "
             << itBottom->first << " pending states");   
 #endif
+    return bb;
+}
+
+bool BlockScheduler::getNext(TBlock *dst)
+{
+    if (d->todo.empty())
+        return false;
+
+    // select the block for processing according to the policy
+    TBlock bb;
+    if (d->useWto) {
+        // the first block in WTO, so that inner loops stabilize first
+        const Private::TWtoSched::iterator itTop = d->wtoSched.begin();
+        bb = itTop->second;
+        d->wtoSched.erase(itTop);
+    }
+    else
+        bb = d->pickByPolicy();
+
     if (1 != d->todo.erase(bb))
         CL_BREAK_IF("BlockScheduler malfunction");
 
+    // update the statistics of visits
+    Private::BlockStats &stats = d->done[bb];
+    stats.cntVisits++;
+    stats.cntHeaps += d->pcp->cntPending(bb);
+
     *dst = bb;
-    d->done[bb]++;
     return true;
 }
 
@@ -450,7 +822,7 @@ void BlockScheduler::printStats() const
     // sort d->todo by cnt
     TRMap rMap;
     BOOST_FOREACH(Private::TDone::const_reference item, d->done) {
-        rMap[/* cnt */ item.second].push_back(/* bb */ item.first);
+        rMap[/* cnt */ item.second.cntVisits].push_back(/* bb */ item.first);
     }
 
     BOOST_FOREACH(TRMap::const_reference item, rMap) {
@@ -463,14 +835,48 @@ void BlockScheduler::printStats() const
             if (hasKey(d->todo, bb))
                 suffix = " [still in the queue]";
 
+            const Private::BlockStats &stats = d->done[bb];
             CL_NOTE_MSG(&first->loc,
                     "___ block " << name
                     << " examined " << cnt
-                    << " times" << suffix);
+                    << " times, " << (stats.cntHeaps / cnt)
+                    << " heap(s) per visit" << suffix);
         }
     }
 }
 
+void BlockScheduler::printVisitStats(const struct cl_loc *loc) const
+{
+    unsigned cntBlocks = 0U;
+    unsigned cntVisits = 0U;
+    unsigned cntHeaps = 0U;
+    unsigned maxVisits = 0U;
+    TBlock maxBlock = 0;
+
+    BOOST_FOREACH(Private::TDone::const_reference item, d->done) {
+        const Private::BlockStats &stats = item.second;
+        ++cntBlocks;
+        cntVisits += stats.cntVisits;
+        cntHeaps += stats.cntHeaps;
+        if (maxVisits < stats.cntVisits) {
+            maxVisits = stats.cntVisits;
+            maxBlock = item.first;
+        }
+    }
+
+    if (!cntVisits)
+        return;
+
+    CL_DEBUG_MSG(loc, "<Q> " << ((d->useWto) ? "WTO" : "default")
+            << " scheduler: " << cntBlocks << " block(s) visited "
+            << cntVisits << " times (" << (cntVisits - cntBlocks)
+            << " re-visits, at most " << maxVisits << " times "
+            << maxBlock->name() << "), " << cntHeaps
+            << " heap(s) processed, " << std::fixed << std::setprecision(2)
+            << (static_cast<float>(cntHeaps) / cntVisits)
+            << " heap(s) per visit");
+}
+
 
 // /////////////////////////////////////////////////////////////////////////////
 // SymStateMarked implementation
@@ -489,7 +895,7 @@ void SymStateMarked::swap(SymState &other)
 
 void SymStateMarked::rotateExisting(const int idxA, const int idxB)
 {
-    SymState::rotateExisting(idxA, idxB);
+    SymStateWithJoin::rotateExisting(idxA, idxB);
 
     TDone::iterator itA = done_.begin() + idxA;
     TDone::iterator itB = done_.begin() + idxB;
@@ -25,10 +25,13 @@
  * @todo update dox
  */
 
+#include <map>
 #include <set>
 #include <vector>
 
+#include "symcmp.hh"
 #include "symheap.hh"
+#include "symjoin.hh"
 
 namespace CodeStorage {
     class Block;
@@ -137,18 +140,80 @@ class SymHeapList: public SymState {
  * symbolically executed function is then the SymState taken from the basic
  * block containing CL_INSN_RET as soon as the fix-point calculation has
  * terminated.
+ *
+ * The heaps are indexed by heapFingerprint() so that lookup() needs to call
+ * areEqual() only on heaps with a colliding fingerprint.
  */
 class SymHeapUnion: public SymState {
     public:
-        virtual int lookup(const SymHeap &sh) const;
+        virtual int lookup(const SymHeap &sh) const {
+            return this->lookup(sh, /* pCntProbes */ 0);
+        }
+
+        /// same as lookup(), adds the count of compared heaps to *pCntProbes
+        int lookup(const SymHeap &sh, unsigned *pCntProbes) const;
+
+        virtual void clear();
+
+        virtual void swap(SymState &other);
+
+    protected:
+        virtual void eraseExisting(int nth);
+
+        virtual void swapExisting(int nth, SymHeap &sh);
+
+        virtual void rotateExisting(const int idxA, const int idxB);
+
+        /// lookup/insert optimization in SymCallCache implementation
+        friend class PerFncCache;
+
+    private:
+        typedef std::vector<THeapFingerprint>                   TFpList;
+        typedef std::multimap<THeapFingerprint, int /* idx */>  TFpIndex;
+
+        /// bring the fingerprints up to date with the list of heaps
+        void syncIndex() const;
+
+        /// fingerprints of the heaps, computed lazily (covers only a prefix)
+        mutable TFpList         fps_;
+
+        /// fingerprint --> indices of heaps, rebuilt from fps_ if invalidated
+        mutable TFpIndex        fpIndex_;
 };
 
+/**
+ * SymHeapUnion that tries to join each inserted heap with the heaps inside.
+ * The JoinSignature of each heap is kept along with it so that the joins that
+ * are guaranteed to fail are skipped without calling joinSymHeaps().
+ */
 class SymStateWithJoin: public SymHeapUnion {
     public:
         virtual bool insert(const SymHeap &sh, bool allowThreeWay = true);
 
+        virtual void clear();
+
+        virtual void swap(SymState &other);
+
+    protected:
+        virtual void eraseExisting(int nth);
+
+        virtual void swapExisting(int nth, SymHeap &sh);
+
+        virtual void rotateExisting(const int idxA, const int idxB);
+
     private:
+        typedef std::vector<JoinSignature>                      TSigList;
+
         void packState(unsigned idx, bool allowThreeWay);
+
+        /// return the signature of the nth heap, compute it if not yet
+        const JoinSignature& sigByIdx(unsigned nth);
+
+        /// return true if it makes sense to call joinSymHeaps() at all
+        bool joinMayMatch(unsigned idxOld, const JoinSignature &sigNew);
+
+        /// signatures of the heaps, computed lazily (covers only a prefix)
+        TSigList                sigs_;
 };
 
 /**
@@ -293,6 +358,9 @@ class SymStateMap: public IPendingCountProvider {
         Private *d;
 };
 
+/// print statistics of joins performed/avoided by SymStateWithJoin
+void printJoinStats();
+
 class IStatsProvider {
     public:
         virtual ~IStatsProvider() { }
@@ -322,6 +390,9 @@ class BlockScheduler: public IStatsProvider {
 
         virtual void printStats() const;
 
+        /// print count of visits and heaps processed per visit (debug output)
+        void printVisitStats(const struct cl_loc *loc) const;
+
     private:
         // not implemented
         BlockScheduler& operator=(const BlockScheduler &);
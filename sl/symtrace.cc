@@ -72,6 +72,61 @@ void Node::notifyDeath(NodeBase *child)
     if (children_.empty())
         // FIXME: this may cause stack overflow on complex trace graphs
         delete this;
+#if SE_SPARSE_TRACE_GRAPH
+    else if (1U == children_.size())
+        this->spliceIntoChild();
+#endif
+}
+
+bool Node::spliceIntoChild()
+{
+    PathNode *self = dynamic_cast<PathNode *>(this);
+    if (!self || 1U != parents_.size() || !idMapper_.empty())
+        // not a node on a linear path
+        return false;
+
+    PathNode *child = dynamic_cast<PathNode *>(children_.front());
+    if (!child)
+        // the only child is a handle or a node we cannot merge into
+        return false;
+
+    const unsigned cntAfter = self->cntAbsorbed_ + child->cntAbsorbed_ + 1U;
+    if (static_cast<unsigned>(SE_SPARSE_TRACE_GRAPH) < cntAfter)
+        // keep this node as a checkpoint
+        return false;
+
+    child->absorb(self);
+
+    // connect the child directly to our parent
+    Node *parent = parents_.front();
+    std::replace(child->parents_.begin(), child->parents_.end(), this, parent);
+    std::replace(parent->children_.begin(), parent->children_.end(),
+            static_cast<NodeBase *>(this), static_cast<NodeBase *>(child));
+
+    // we are no longer connected to anything
+    parents_.clear();
+    children_.clear();
+    delete this;
+    return true;
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of Trace::PathNode
+
+void PathNode::absorb(PathNode *pred)
+{
+    // the steps of the predecessor go first
+    TCondList own;
+    own.swap(absorbedConds_);
+    absorbedConds_.swap(pred->absorbedConds_);
+
+    CondStep step;
+    if (pred->condStep(&step))
+        absorbedConds_.push_back(step);
+
+    absorbedConds_.insert(absorbedConds_.end(), own.begin(), own.end());
+    cntAbsorbed_ += pred->cntAbsorbed_ + 1U;
 }
 
 
@@ -85,12 +140,13 @@ void NodeHandle::reset(Node *node)
         // if the node is already in, protect it against accidental deallocation
         return;
 
-    // release the old node
-    ref->notifyDeath(this);
-
-    // register the new node
+    // register the new node first, the old one may be its (only) parent
+    Node *old = ref;
     ref = node;
     ref->notifyBirth(this);
+
+    // release the old node
+    old->notifyDeath(this);
 }
 
 
@@ -339,6 +395,18 @@ void plotTraceCore(TracePlotter &tplot)
         if (!to)
             continue;
 
+        const PathNode *pathNode = dynamic_cast<const PathNode *>(to);
+        if (pathNode && pathNode->cntAbsorbed()) {
+            // the edge stands for a sequence of merged nodes
+            tplot.out << "\t" << SL_QUOTE(now)
+                << " -> " << SL_QUOTE(to)
+                << " [color=black, fontcolor=black, style=dashed, label="
+                << SL_QUOTE(pathNode->cntAbsorbed() << " steps, "
+                        << pathNode->absorbedConds().size() << " conditions")
+                << "];\n";
+            continue;
+        }
+
         tplot.out << "\t" << SL_QUOTE(now)
             << " -> " << SL_QUOTE(to)
             << " [color=black, fontcolor=black];\n";
@@ -407,9 +475,29 @@ Node* /* selected predecessor */ RootNode::printNode() const
     return 0;
 }
 
+void printCondStep(const TInsn inCmp, const bool determ, const bool branch)
+{
+    const char *action = (determ)
+        ? "evaluated as "
+        : "assuming ";
+
+    const char *result = (branch)
+        ? "TRUE"
+        : "FALSE";
+
+    CL_NOTE_MSG(&inCmp->loc, (*inCmp) << " ... " << action << result);
+}
+
+void PathNode::printAbsorbed() const
+{
+    BOOST_REVERSE_FOREACH(const CondStep &step, absorbedConds_)
+        printCondStep(step.inCmp, step.determ, step.branch);
+}
+
 Node* /* selected predecessor */ InsnNode::printNode() const
 {
     // TODO: handle selected instructions here?
+    this->printAbsorbed();
     return this->parent();
 }
 
@@ -422,6 +510,7 @@ Node* /* selected predecessor */ JoinNode::printNode() const
 Node* /* selected predecessor */ CloneNode::printNode() const
 {
     CL_BREAK_IF("please implement");
+    this->printAbsorbed();
     return this->parent();
 }
 
@@ -451,18 +540,20 @@ Node* /* selected predecessor */ CallDoneNode::printNode() const
 
 Node* /* selected predecessor */ CondNode::printNode() const
 {
-    const char *action = (determ_)
-        ? "evaluated as "
-        : "assuming ";
-
-    const char *result = (branch_)
-        ? "TRUE"
-        : "FALSE";
-
-    CL_NOTE_MSG(&inCmp_->loc, (*inCmp_) << " ... " << action << result);
+    printCondStep(inCmp_, determ_, branch_);
+    this->printAbsorbed();
     return this->parent();
 }
 
+bool CondNode::condStep(CondStep *pDst) const
+{
+    pDst->inCmp     = inCmp_;
+    pDst->inCnd     = inCnd_;
+    pDst->determ    = determ_;
+    pDst->branch    = branch_;
+    return true;
+}
+
 Node* /* selected predecessor */ UserNode::printNode() const
 {
     CL_BREAK_IF("please implement");
@@ -94,6 +94,9 @@ class Node: public NodeBase {
         /// death notification from a child node
         void notifyDeath(NodeBase *child);
 
+        /// merge this node into its only child if possible (sparse trace graph)
+        bool /* deleted */ spliceIntoChild();
+
         friend class NodeBase;
         friend class NodeHandle;
 
@@ -153,6 +156,48 @@ class Node: public NodeBase {
         TBaseList children_;
 };
 
+/// a node on a linear path that can absorb its predecessors if sparse mode is on
+class PathNode: public Node {
+    public:
+        /// a condition traversed by one of the absorbed predecessors
+        struct CondStep {
+            TInsn   inCmp;
+            TInsn   inCnd;
+            bool    determ;
+            bool    branch;
+        };
+
+        typedef std::vector<CondStep> TCondList;
+
+        /// count of predecessors merged into this node, see SE_SPARSE_TRACE_GRAPH
+        unsigned cntAbsorbed() const { return cntAbsorbed_; }
+
+        /// conditions traversed by the absorbed predecessors, the oldest first
+        const TCondList& absorbedConds() const { return absorbedConds_; }
+
+    protected:
+        PathNode(Node *ref):
+            Node(ref),
+            cntAbsorbed_(0U)
+        {
+        }
+
+        /// describe the condition represented by this node (if any)
+        virtual bool condStep(CondStep *) const { return false; }
+
+        /// print the absorbed conditions, the most recent first
+        void printAbsorbed() const;
+
+    private:
+        unsigned    cntAbsorbed_;
+        TCondList   absorbedConds_;
+
+        /// take over the (already absorbed) steps of the given predecessor
+        void absorb(PathNode *pred);
+
+        friend class Node;
+};
+
 /// useful to prevent a trace sub-graph from being destroyed too early
 class NodeHandle: public NodeBase {
     public:
@@ -222,7 +267,7 @@ class RootNode: public Node {
 };
 
 /// a trace graph node that represents a non-terminal instruction
-class InsnNode: public Node {
+class InsnNode: public PathNode {
     private:
         const TInsn insn_;
         const bool  isBuiltin_;
@@ -234,7 +279,7 @@ class InsnNode: public Node {
          * @param isBuiltin true, if the instruction is recognized as a built-in
          */
         InsnNode(Node *ref, TInsn insn, const bool isBuiltin):
-            Node(ref),
+            PathNode(ref),
             insn_(insn),
             isBuiltin_(isBuiltin)
         {
@@ -248,7 +293,7 @@ class InsnNode: public Node {
 };
 
 /// a trace graph node that represents a conditional insn being traversed
-class CondNode: public Node {
+class CondNode: public PathNode {
     private:
         const TInsn inCmp_;
         const TInsn inCnd_;
@@ -264,7 +309,7 @@ class CondNode: public Node {
          * @param branch true if the 'then' branch was taken, false for 'else'
          */
         CondNode(Node *ref, TInsn inCmp, TInsn inCnd, bool determ, bool branch):
-            Node(ref),
+            PathNode(ref),
             inCmp_(inCmp),
             inCnd_(inCnd),
             determ_(determ),
@@ -277,6 +322,7 @@ class CondNode: public Node {
 
     protected:
         void virtual plotNode(TracePlotter &) const;
+        virtual bool condStep(CondStep *) const;
 };
 
 /// a trace graph node that represents a @b single abstraction step
@@ -365,10 +411,10 @@ class JoinNode: public Node {
 };
 
 /// trace graph nodes inserted automatically per each SymHeap clone operation
-class CloneNode: public Node {
+class CloneNode: public PathNode {
     public:
         CloneNode(Node *ref):
-            Node(ref)
+            PathNode(ref)
         {
         }
 